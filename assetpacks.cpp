@@ -0,0 +1,44 @@
+#include "assetpacks.h"
+
+#include <QCoreApplication>
+#include <QResource>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QDebug>
+
+static QString packPath(const QString& name)
+{
+    return QCoreApplication::applicationDirPath() + "/assets/" + name + ".rcc";
+}
+
+// Регистрирует пакет, если файл есть. Пакеты остаются подключенными до выхода
+static bool registerPack(const QString& name)
+{
+    static QMutex mutex;
+    static QSet<QString> registered;
+
+    QMutexLocker locker(&mutex);
+    if (registered.contains(name)) return true;
+
+    const QString path = packPath(name);
+    if (!QFileInfo::exists(path)) return false;
+
+    if (!QResource::registerResource(path)) {
+        qWarning() << "AssetPacks: не удалось подключить" << path;
+        return false;
+    }
+    registered.insert(name);
+    return true;
+}
+
+bool AssetPacks::registerCore()
+{
+    return registerPack("core");
+}
+
+bool AssetPacks::ensureStyle(int styleId)
+{
+    return registerPack(QString("style_%1").arg(styleId));
+}
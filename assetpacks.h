@@ -0,0 +1,20 @@
+#ifndef ASSETPACKS_H
+#define ASSETPACKS_H
+
+// Внешние пакеты ресурсов (.rcc рядом с exe, папка "assets").
+// При сборке с MEMORY_EXTERNAL_ASSETS картинки и звуки не встраиваются в exe,
+// а лежат в assets/core.rcc (меню, звуки, иконки) и assets/style_N.rcc (атласы стиля).
+// QResource::registerResource отображает файл в память (mmap), поэтому
+// в память попадают только реально прочитанные страницы.
+// Если пакетов нет (ресурсы встроены в exe), все функции ничего не делают.
+namespace AssetPacks {
+
+// Подключает основной пакет. Вызывается один раз при старте, до создания окон
+bool registerCore();
+
+// Подключает пакет стиля при первом обращении к нему (можно из любого потока)
+bool ensureStyle(int styleId);
+
+}
+
+#endif // ASSETPACKS_H
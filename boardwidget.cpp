@@ -0,0 +1,218 @@
+#include "boardwidget.h"
+#include "cardskin.h"
+#include "imagecache.h"
+#include "latencyprobe.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QFont>
+
+BoardWidget::BoardWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    // Нужен для подсветки рамки под курсором (как :hover у кнопок)
+    setMouseTracking(true);
+
+    cardStyle = StyleCatalog::instance().styleOrDefault(1);
+
+    connect(&ImageCache::instance(), &ImageCache::styleReady, this, &BoardWidget::onStyleImagesReady);
+}
+
+void BoardWidget::setBoardSize(int rows, int cols) {
+    pressedIndex = -1;
+
+    faceUpMask = 0;
+    matchedMask = 0;
+    enabledMask = 0;
+
+    // Новая игра на том же поле: массив и геометрия виджета остаются прежними
+    if (rows == rowCount && cols == colCount) {
+        update();
+        return;
+    }
+
+    rowCount = rows;
+    colCount = cols;
+    ids.fill(0, rows * cols);
+    hoveredIndex = -1;
+
+    setFixedSize(sizeHint());
+    update();
+}
+
+void BoardWidget::setCardStyle(const StyleInfo& style) {
+    cardStyle = style;
+    update();
+}
+
+void BoardWidget::setCardIds(const CardId* cardIds) {
+    std::copy(cardIds, cardIds + ids.size(), ids.begin());
+    // Закрытые карты картинку не показывают, перерисовывать нечего
+}
+
+QSize BoardWidget::faceSize() const {
+    return CardSkin::faceRect().size();
+}
+
+void BoardWidget::setFaceUpCards(CardMask mask) {
+    CardMask changed = faceUpMask ^ mask;
+    faceUpMask = mask;
+    updateCards(changed);
+}
+
+void BoardWidget::setMatchedCards(CardMask mask) {
+    CardMask changed = matchedMask ^ mask;
+    matchedMask = mask;
+    updateCards(changed);
+}
+
+void BoardWidget::setEnabledCards(CardMask mask) {
+    CardMask changed = enabledMask ^ mask;
+    enabledMask = mask;
+    // Активность видна только у карты под курсором (рамка :hover)
+    if (hoveredIndex >= 0 && (changed & cardBit(hoveredIndex))) updateCard(hoveredIndex);
+}
+
+QRect BoardWidget::cardRect(int index) const {
+    int row = index / colCount;
+    int col = index % colCount;
+    return QRect(BOARD_MARGIN + col * (CARD_SIZE + CARD_SPACING),
+                 BOARD_MARGIN + row * (CARD_SIZE + CARD_SPACING),
+                 CARD_SIZE, CARD_SIZE);
+}
+
+QSize BoardWidget::sizeHint() const {
+    int width = 2 * BOARD_MARGIN + colCount * CARD_SIZE + qMax(0, colCount - 1) * CARD_SPACING;
+    int height = 2 * BOARD_MARGIN + rowCount * CARD_SIZE + qMax(0, rowCount - 1) * CARD_SPACING;
+    return QSize(width, height);
+}
+
+int BoardWidget::cardIndexAt(const QPoint& pos) const {
+    int x = pos.x() - BOARD_MARGIN;
+    int y = pos.y() - BOARD_MARGIN;
+    if (x < 0 || y < 0) return -1;
+
+    const int step = CARD_SIZE + CARD_SPACING;
+    int col = x / step;
+    int row = y / step;
+    if (row >= rowCount || col >= colCount) return -1;
+    // Попали в промежуток между картами
+    if (x % step >= CARD_SIZE || y % step >= CARD_SIZE) return -1;
+    return row * colCount + col;
+}
+
+void BoardWidget::updateCard(int index) {
+    if (index < 0 || colCount == 0) return;
+    update(cardRect(index));
+}
+
+void BoardWidget::updateCards(CardMask mask) {
+    for (; mask; mask &= mask - 1) {
+        updateCard(lowestCard(mask));
+    }
+}
+
+void BoardWidget::setHovered(int index) {
+    if (index == hoveredIndex) return;
+    int previous = hoveredIndex;
+    hoveredIndex = index;
+    updateCard(previous);
+    updateCard(index);
+}
+
+void BoardWidget::onStyleImagesReady(int styleId, qreal devicePixelRatio) {
+    if (styleId != cardStyle.id || !qFuzzyCompare(devicePixelRatio, devicePixelRatioF())) return;
+
+    updateCards(faceUpMask | matchedMask);
+}
+
+void BoardWidget::paintEvent(QPaintEvent *event) {
+    if (ids.isEmpty()) return;
+
+    // Готовые рубашки и рамки под плотность пикселей текущего экрана
+    const qreal ratio = devicePixelRatioF();
+    const CardSkin& skin = CardSkin::forStyle(cardStyle, ratio);
+    // Пока стиль декодируется, атлас пустой: открытые карты рисуются без картинки
+    // и дорисуются по сигналу styleReady
+    const StyleAtlas faces = ImageCache::instance().atlas(cardStyle.id, ratio);
+
+    QPainter painter(this);
+
+    // Рисуем только карты, задетые обновляемой областью
+    const QRect dirty = event->rect();
+    CardMask painted = 0;
+    for (int i = 0; i < ids.size(); ++i) {
+        if (cardRect(i).intersects(dirty)) {
+            paintCard(painter, skin, faces, i);
+            painted |= cardBit(i);
+        }
+    }
+    LatencyProbe::instance().paintFinished(painted);
+}
+
+void BoardWidget::paintCard(QPainter& painter, const CardSkin& skin, const StyleAtlas& faces, int index) const {
+    const CardMask bit = cardBit(index);
+    const bool matched = matchedMask & bit;
+    const QPoint origin = cardRect(index).topLeft();
+
+    if (!(faceUpMask & bit) && !matched) {
+        bool hovered = index == hoveredIndex && (enabledMask & bit);
+        painter.drawPixmap(origin, hovered ? skin.backHover : skin.back);
+        return;
+    }
+
+    painter.drawPixmap(origin, matched ? skin.matchedBase : skin.faceBase);
+
+    if (!faces.isNull()) {
+        // Картинка рисуется прямо из атласа стиля по номеру карты,
+        // путей к файлам поле не хранит
+        const QRect face = CardSkin::faceRect().translated(origin);
+        const bool drawn = faces.drawCard(painter, face, ids[index]);
+        LatencyProbe::instance().mark(index, LatencyProbe::Pixmap);
+        if (!drawn) {
+            painter.setPen(Qt::white);
+            QFont font = painter.font();
+            font.setBold(true);
+            font.setPixelSize(16);
+            painter.setFont(font);
+            painter.drawText(face, Qt::AlignCenter, "Image\nNot Found");
+        }
+    }
+
+    painter.drawPixmap(origin, matched ? skin.matchedFrame : skin.faceFrame);
+}
+
+void BoardWidget::mousePressEvent(QMouseEvent *event) {
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    int index = cardIndexAt(event->position().toPoint());
+    pressedIndex = (index >= 0 && isCardEnabled(index)) ? index : -1;
+}
+
+void BoardWidget::mouseReleaseEvent(QMouseEvent *event) {
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+    // Как у кнопки: клик засчитывается, если отпустили на той же карте
+    int index = cardIndexAt(event->position().toPoint());
+    int pressed = pressedIndex;
+    pressedIndex = -1;
+    if (index < 0 || index != pressed || !isCardEnabled(index)) return;
+
+    // Начало замера задержки до отрисовки карты (если включен)
+    LatencyProbe::instance().clickDelivered(index);
+    emit cardClicked(index);
+}
+
+void BoardWidget::mouseMoveEvent(QMouseEvent *event) {
+    setHovered(cardIndexAt(event->position().toPoint()));
+    QWidget::mouseMoveEvent(event);
+}
+
+void BoardWidget::leaveEvent(QEvent *event) {
+    setHovered(-1);
+    QWidget::leaveEvent(event);
+}
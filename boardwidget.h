@@ -0,0 +1,111 @@
+#ifndef BOARDWIDGET_H
+#define BOARDWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+
+#include "styleatlas.h"
+#include "stylecatalog.h"
+#include "gameengine.h"
+
+class CardSkin;
+
+// Игровое поле целиком - один виджет вместо отдельной QPushButton на каждую карту.
+// Все карты рисуются в одном paintEvent, клик переводится в индекс карты
+// простой арифметикой по координатам, а при изменении карты перерисовывается
+// только ее прямоугольник. Так не нужно создавать и раскладывать десятки
+// виджетов со своими таблицами стилей на каждую новую игру.
+// Рубашки и рамки не рисуются заново: они берутся готовыми из CardSkin.
+//
+// Карты нумеруются так же, как в GameEngine: индекс = row * cols + col.
+// Поле хранит только номер картинки каждой карты (CardId), сама картинка
+// рисуется из атласа стиля (ImageCache) в момент отрисовки. Поэтому после фонового
+// декодирования или переезда на экран с другим devicePixelRatio поле
+// само перерисовывает открытые карты.
+//
+// Состояние карт задается наборами CardMask целиком (как их хранит движок),
+// перерисовываются только карты, чьи биты изменились.
+//
+// Виджет ничего не знает о правилах игры: он только показывает то,
+// что ему выставили (рубашка, картинка, найденная пара) и сообщает о кликах.
+class BoardWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static const int CARD_SPACING = 10; // расстояние между картами
+    static const int BOARD_MARGIN = 10; // отступ от края поля
+
+    explicit BoardWidget(QWidget *parent = nullptr);
+
+    // Задает размер поля. Все карты становятся закрытыми и неактивными
+    void setBoardSize(int rows, int cols);
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    int cardCount() const { return ids.size(); }
+
+    // Рубашка, рамки и картинки карт берутся из описания стиля
+    void setCardStyle(const StyleInfo& style);
+
+    // Номера картинок всех карт (cardCount() штук, как в GameEngine::cardData)
+    void setCardIds(const CardId* ids);
+
+    // Размер картинки на открытой карте (в логических пикселях)
+    QSize faceSize() const;
+
+    // Открытые карты показывают картинку, закрытые - рубашку.
+    // Если картинки нет в стиле - надпись "Image Not Found"
+    void setFaceUpCards(CardMask mask);
+    CardMask faceUpCards() const { return faceUpMask; }
+
+    // Найденные пары: зеленый фон и синяя рамка
+    void setMatchedCards(CardMask mask);
+    CardMask matchedCards() const { return matchedMask; }
+
+    // Активные карты. Остальные не реагируют на мышь
+    void setEnabledCards(CardMask mask);
+    bool isCardEnabled(int index) const { return enabledMask & cardBit(index); }
+
+    // Прямоугольник карты в координатах виджета
+    QRect cardRect(int index) const;
+
+    QSize sizeHint() const override;
+
+signals:
+    // Клик по активной карте
+    void cardClicked(int index);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+
+private slots:
+    // Картинки стиля декодированы в фоне - открытые карты можно дорисовать
+    void onStyleImagesReady(int styleId, qreal devicePixelRatio);
+
+private:
+    // Индекс карты под точкой или -1 (промежутки между картами не считаются)
+    int cardIndexAt(const QPoint& pos) const;
+    void updateCard(int index);
+    void updateCards(CardMask mask);
+    void setHovered(int index);
+    void paintCard(QPainter& painter, const CardSkin& skin, const StyleAtlas& faces, int index) const;
+
+    int rowCount = 0;
+    int colCount = 0;
+    QVector<CardId> ids; // номер картинки каждой карты, индекс = row * cols + col
+
+    CardMask faceUpMask = 0;
+    CardMask matchedMask = 0;
+    CardMask enabledMask = 0;
+
+    int hoveredIndex = -1; // карта под курсором
+    int pressedIndex = -1; // карта, на которой нажали кнопку мыши
+
+    StyleInfo cardStyle; // стиль рубашки, картинки для него готовит CardSkin
+};
+
+#endif // BOARDWIDGET_H
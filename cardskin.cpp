@@ -0,0 +1,124 @@
+#include "cardskin.h"
+#include "stylecatalog.h"
+#include "styleatlas.h"
+#include <QPainter>
+#include <QLinearGradient>
+
+namespace {
+
+// Ключ набора: стиль и плотность пикселей экрана
+struct SkinKey {
+    int styleId;
+    qreal devicePixelRatio;
+
+    bool operator==(const SkinKey& other) const {
+        return styleId == other.styleId && devicePixelRatio == other.devicePixelRatio;
+    }
+};
+
+size_t qHash(const SkinKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.styleId, key.devicePixelRatio);
+}
+
+// Пустая прозрачная картинка размером с клетку под нужный экран
+QPixmap makeCell(qreal devicePixelRatio)
+{
+    QSize size = CardSkin::cellSize();
+    QPixmap pixmap(qRound(size.width() * devicePixelRatio), qRound(size.height() * devicePixelRatio));
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+    return pixmap;
+}
+
+// Скругленная рамка рубашки (внутри отступа карты, с учетом толщины линии 2px)
+QRectF frameRect()
+{
+    return QRectF(CardSkin::faceRect()).adjusted(1, 1, -1, -1);
+}
+
+QPixmap renderBackFill(const StyleInfo& style, qreal devicePixelRatio)
+{
+    QPixmap pixmap = makeCell(devicePixelRatio);
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QRect inner = CardSkin::faceRect();
+    QLinearGradient gradient(inner.topLeft(), inner.bottomLeft());
+    gradient.setColorAt(0, style.backTop);
+    gradient.setColorAt(1, style.backBottom);
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(gradient);
+    painter.drawRoundedRect(frameRect(), 12, 12);
+    return pixmap;
+}
+
+QPixmap renderFrame(const QColor& color, qreal devicePixelRatio)
+{
+    QPixmap pixmap = makeCell(devicePixelRatio);
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(color, 2));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRoundedRect(frameRect(), 12, 12);
+    return pixmap;
+}
+
+// Рубашка целиком: фон и рамка одной картинкой
+QPixmap renderBack(const QPixmap& fill, const QPixmap& frame)
+{
+    QPixmap pixmap = fill;
+    QPainter painter(&pixmap);
+    painter.drawPixmap(0, 0, frame);
+    return pixmap;
+}
+
+} // namespace
+
+QSize CardSkin::cellSize()
+{
+    return QSize(CARD_SIZE, CARD_SIZE);
+}
+
+QRect CardSkin::faceRect()
+{
+    return QRect(QPoint(0, 0), cellSize()).adjusted(CARD_MARGIN, CARD_MARGIN, -CARD_MARGIN, -CARD_MARGIN);
+}
+
+const CardSkin& CardSkin::forStyle(const StyleInfo& style, qreal devicePixelRatio)
+{
+    // Используется только из GUI-потока (QPixmap), блокировка не нужна
+    static QHash<SkinKey, CardSkin> skins;
+
+    SkinKey key{style.id, devicePixelRatio};
+    auto it = skins.constFind(key);
+    if (it == skins.constEnd()) {
+        it = skins.insert(key, render(style, devicePixelRatio));
+    }
+    return it.value();
+}
+
+CardSkin CardSkin::render(const StyleInfo& style, qreal devicePixelRatio)
+{
+    CardSkin skin;
+
+    skin.faceBase = renderBackFill(style, devicePixelRatio);
+    skin.faceFrame = renderFrame(style.border, devicePixelRatio);
+    skin.back = renderBack(skin.faceBase, skin.faceFrame);
+    skin.backHover = renderBack(skin.faceBase, renderFrame(Qt::white, devicePixelRatio));
+
+    // Найденная пара: квадратная клетка с зеленым фоном и синей рамкой 4px
+    skin.matchedBase = makeCell(devicePixelRatio);
+    skin.matchedBase.fill(QColor("#aaf0aa"));
+
+    skin.matchedFrame = makeCell(devicePixelRatio);
+    {
+        QPainter painter(&skin.matchedFrame);
+        painter.setPen(QPen(Qt::blue, 4));
+        painter.setBrush(Qt::NoBrush);
+        painter.drawRect(QRectF(QRect(QPoint(0, 0), cellSize())).adjusted(2, 2, -2, -2));
+    }
+
+    return skin;
+}
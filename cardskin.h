@@ -0,0 +1,43 @@
+#ifndef CARDSKIN_H
+#define CARDSKIN_H
+
+#include <QPixmap>
+#include <QHash>
+#include <QSize>
+
+struct StyleInfo;
+
+// Заранее нарисованные части карты одного стиля: рубашка, рамки,
+// фон найденной пары. Рисуются один раз на стиль и devicePixelRatio,
+// дальше каждая карта поля просто копирует готовую картинку (drawPixmap),
+// без градиентов, сглаживания и таблиц стилей на каждую отрисовку.
+//
+// Все картинки размером с клетку карты (CARD_SIZE) и с прозрачным фоном,
+// кладутся одна на другую в одной и той же точке:
+//   закрытая карта        - back (или backHover под курсором)
+//   открытая карта        - faceBase, картинка, faceFrame
+//   найденная пара        - matchedBase, картинка, matchedFrame
+class CardSkin
+{
+public:
+    // Готовый набор для стиля. Рисуется при первом обращении и дальше
+    // живет до конца программы (стилей немного, каждый - пара десятков КБ)
+    static const CardSkin& forStyle(const StyleInfo& style, qreal devicePixelRatio);
+
+    // Размер клетки и область под картинку (в логических пикселях).
+    // Область под картинку - CARD_FACE_SIZE, в нем же собраны атласы
+    static QSize cellSize();
+    static QRect faceRect();
+
+    QPixmap back;
+    QPixmap backHover;
+    QPixmap faceBase;
+    QPixmap faceFrame;
+    QPixmap matchedBase;
+    QPixmap matchedFrame;
+
+private:
+    static CardSkin render(const StyleInfo& style, qreal devicePixelRatio);
+};
+
+#endif // CARDSKIN_H
@@ -0,0 +1,248 @@
+#include "coinledger.h"
+#include "settingsstore.h"
+#include <QCoreApplication>
+#include <QSaveFile>
+#include <QTimer>
+#include <QtEndian>
+#include <QDebug>
+#include <QStringList>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char SNAPSHOT_MAGIC[4] = {'M', 'M', 'C', 'S'};
+// 1 - только баланс, 2 - баланс и купленные стили
+const quint16 SNAPSHOT_VERSION = 2;
+
+// FNV-1a: контрольная сумма записи (ловит недописанные и испорченные записи)
+quint32 checksum(const uchar* data, int size)
+{
+    quint32 hash = 2166136261u;
+    for (int i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+} // namespace
+
+CoinLedger& CoinLedger::instance() {
+    static CoinLedger ledger;
+    return ledger;
+}
+
+CoinLedger::CoinLedger()
+    : snapshotPath(SettingsStore::dataDir() + "/coins.snapshot")
+    , journal(SettingsStore::dataDir() + "/coins.journal")
+    , syncTimer(new QTimer(this))
+{
+    const bool snapshotLoaded = loadSnapshot();
+    if (!snapshotLoaded) {
+        // Первый запуск с журналом (или снимок испорчен): баланс из прежнего
+        // сохранения, а журнал учитывается целиком, с первой записи
+        currentBalance = SettingsStore::instance().value("coins", 1000).toLongLong();
+        lastSequence = 0;
+        importLegacyStyles();
+    }
+
+    if (!journal.open(QIODevice::ReadWrite)) {
+        qWarning() << "Не удалось открыть журнал монет" << journal.fileName() << journal.errorString();
+    } else {
+        replayJournal();
+    }
+
+    if (!snapshotLoaded) writeSnapshot();
+
+    syncTimer->setSingleShot(true);
+    syncTimer->setInterval(SYNC_DELAY_MS);
+    connect(syncTimer, &QTimer::timeout, this, &CoinLedger::sync);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &CoinLedger::sync);
+    }
+}
+
+CoinLedger::~CoinLedger() {
+    if (journal.isOpen()) journal.flush();
+}
+
+bool CoinLedger::loadSnapshot() {
+    QFile file(snapshotPath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const QByteArray data = file.readAll();
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+
+    // Версия 1 - тот же заголовок без стилей (на месте их числа были нули)
+    const int version = data.size() >= SNAPSHOT_HEADER_SIZE ? qFromLittleEndian<quint16>(bytes + 4) : 0;
+    const int styleCount = version == SNAPSHOT_VERSION ? qFromLittleEndian<quint16>(bytes + 6) : 0;
+    const int size = SNAPSHOT_HEADER_SIZE + styleCount * 2;
+    if (data.size() != size + 4 || !data.startsWith(QByteArray(SNAPSHOT_MAGIC, 4))
+        || (version != 1 && version != SNAPSHOT_VERSION)
+        || qFromLittleEndian<quint32>(bytes + size) != checksum(bytes, size)) {
+        qWarning() << "Снимок монет поврежден, баланс восстанавливается из save.ini и журнала" << snapshotPath;
+        return false;
+    }
+
+    snapshotSequence = qFromLittleEndian<quint32>(bytes + 8);
+    lastSequence = snapshotSequence;
+    currentBalance = qFromLittleEndian<qint64>(bytes + 12);
+    for (int i = 0; i < styleCount; ++i) {
+        purchased.insert(qFromLittleEndian<quint16>(bytes + SNAPSHOT_HEADER_SIZE + i * 2));
+    }
+    if (version == 1) {
+        // До версии 2 купленные стили хранились только в save.ini
+        importLegacyStyles();
+    }
+    return true;
+}
+
+void CoinLedger::importLegacyStyles() {
+    // Строка вида "1,2,3"
+    const QStringList unlocked = SettingsStore::instance().value("unlocked_styles").toString().split(',', Qt::SkipEmptyParts);
+    for (const QString& text : unlocked) {
+        const int styleId = text.toInt();
+        if (styleId > 0 && styleId <= 0xFFFF && styleId != FREE_STYLE) purchased.insert(styleId);
+    }
+}
+
+bool CoinLedger::writeSnapshot() {
+    // Номера стилей по порядку: одинаковые наборы дают одинаковый файл
+    QList<int> styles = purchased.values();
+    std::sort(styles.begin(), styles.end());
+
+    const int size = SNAPSHOT_HEADER_SIZE + int(styles.size()) * 2;
+    QByteArray data(size + 4, '\0');
+    uchar* bytes = reinterpret_cast<uchar*>(data.data());
+    memcpy(bytes, SNAPSHOT_MAGIC, 4);
+    qToLittleEndian<quint16>(SNAPSHOT_VERSION, bytes + 4);
+    qToLittleEndian<quint16>(quint16(styles.size()), bytes + 6);
+    qToLittleEndian<quint32>(lastSequence, bytes + 8);
+    qToLittleEndian<qint64>(currentBalance, bytes + 12);
+    for (int i = 0; i < styles.size(); ++i) {
+        qToLittleEndian<quint16>(quint16(styles[i]), bytes + SNAPSHOT_HEADER_SIZE + i * 2);
+    }
+    qToLittleEndian<quint32>(checksum(bytes, size), bytes + size);
+
+    QSaveFile file(snapshotPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Не удалось записать снимок монет" << snapshotPath << file.errorString();
+        return false;
+    }
+    snapshotSequence = lastSequence;
+    return true;
+}
+
+void CoinLedger::replayJournal() {
+    const QByteArray data = journal.readAll();
+    const uchar* bytes = reinterpret_cast<const uchar*>(data.constData());
+
+    // Обрезается только хвост после последней целой записи (сбой посреди записи).
+    // Испорченная запись в середине пропускается, записи после нее учитываются
+    qint64 validSize = 0;
+    for (qint64 pos = 0; pos + RECORD_SIZE <= data.size(); pos += RECORD_SIZE) {
+        const uchar* record = bytes + pos;
+        if (qFromLittleEndian<quint32>(record + 12) != checksum(record, 12)) continue;
+
+        quint32 sequence = qFromLittleEndian<quint32>(record);
+        // Записи, уже учтенные в снимке (сбой между снимком и очисткой журнала), пропускаются.
+        // Пропуск номеров записи не отменяет: после них могут быть настоящие награды
+        if (sequence > lastSequence) {
+            if (sequence != lastSequence + 1 && lastSequence != 0) {
+                qWarning() << "В журнале монет пропущены записи" << lastSequence + 1 << "-" << sequence - 1;
+            }
+            currentBalance += qFromLittleEndian<qint32>(record + 4);
+            if (qFromLittleEndian<quint16>(record + 8) == StylePurchase) {
+                purchased.insert(qFromLittleEndian<quint16>(record + 10));
+            }
+            lastSequence = sequence;
+        }
+        validSize = pos + RECORD_SIZE;
+        journalRecords++;
+    }
+
+    if (validSize != data.size()) {
+        qWarning() << "Журнал монет обрезан после последней целой записи:" << validSize << "из" << data.size() << "байт";
+        journal.resize(validSize);
+    }
+    journal.seek(validSize);
+
+    if (journalRecords >= COMPACT_RECORDS) compact();
+}
+
+void CoinLedger::add(qint32 amount, Kind kind, quint16 detail) {
+    if (amount == 0) return;
+    append(amount, kind, detail);
+}
+
+bool CoinLedger::spend(qint32 cost, Kind kind, quint16 detail) {
+    if (cost < 0 || currentBalance < cost) return false;
+    append(-cost, kind, detail);
+    return true;
+}
+
+bool CoinLedger::buyStyle(int styleId, qint32 cost) {
+    // Номер стиля пишется в запись журнала (2 байта)
+    if (styleId <= 0 || styleId > 0xFFFF) {
+        qWarning() << "Номер стиля не помещается в журнал монет:" << styleId;
+        return false;
+    }
+    if (isStyleUnlocked(styleId) || !spend(cost, StylePurchase, quint16(styleId))) return false;
+    // Покупки редки, их запись сразу сбрасывается на диск
+    sync();
+    return true;
+}
+
+void CoinLedger::append(qint32 amount, Kind kind, quint16 detail) {
+    currentBalance += amount;
+    lastSequence++;
+    if (kind == StylePurchase) purchased.insert(detail);
+
+    if (journal.isOpen()) {
+        uchar record[RECORD_SIZE];
+        qToLittleEndian<quint32>(lastSequence, record);
+        qToLittleEndian<qint32>(amount, record + 4);
+        qToLittleEndian<quint16>(kind, record + 8);
+        qToLittleEndian<quint16>(detail, record + 10);
+        qToLittleEndian<quint32>(checksum(record, 12), record + 12);
+
+        // Запись уходит в ОС сразу, на диск - вместе с соседними (sync)
+        if (journal.write(reinterpret_cast<const char*>(record), RECORD_SIZE) != RECORD_SIZE || !journal.flush()) {
+            qWarning() << "Не удалось дописать журнал монет" << journal.errorString();
+        }
+        journalRecords++;
+        if (!syncTimer->isActive()) syncTimer->start();
+    }
+
+    emit balanceChanged(currentBalance);
+
+    if (journalRecords >= COMPACT_RECORDS) compact();
+}
+
+void CoinLedger::sync() {
+    syncTimer->stop();
+    if (!journal.isOpen()) return;
+    journal.flush();
+#ifdef Q_OS_WIN
+    _commit(journal.handle());
+#else
+    ::fsync(journal.handle());
+#endif
+}
+
+void CoinLedger::compact() {
+    // Снимок пишется раньше очистки: если между ними случится сбой,
+    // при запуске записи журнала пропустятся по номерам
+    sync();
+    if (!writeSnapshot()) return;
+
+    journal.resize(0);
+    journal.seek(0);
+    journalRecords = 0;
+}
@@ -0,0 +1,100 @@
+#ifndef COINLEDGER_H
+#define COINLEDGER_H
+
+#include <QObject>
+#include <QFile>
+#include <QSet>
+
+class QTimer;
+
+// Монеты игрока: баланс в памяти, каждое изменение - запись в журнал.
+//
+// Журнал (coins.journal рядом с exe) только дописывается, записи одного размера:
+//   номер (4 байта), изменение (4, со знаком), вид (2), подробность (2),
+//   контрольная сумма (4) - всего RECORD_SIZE байт, little-endian.
+// Награда или покупка - одна запись в конец файла, файл не перечитывается
+// и не переписывается. Сброс на диск (fsync) собирается раз в SYNC_DELAY_MS.
+//
+// Купленные стили тоже берутся из журнала: покупка - одна запись StylePurchase
+// (списание и номер стиля вместе), так что сбой не может оставить игрока
+// без стиля, за который монеты уже списаны.
+//
+// Снимок (coins.snapshot) хранит баланс, купленные стили и номер последней
+// учтенной записи.
+// Когда журнал дорастает до COMPACT_RECORDS записей, пишется новый снимок
+// (QSaveFile - целиком или никак) и журнал очищается. При запуске
+// к снимку прибавляются записи журнала с большими номерами, поэтому
+// сбой в любой момент не теряет и не учитывает дважды ни одной записи,
+// а недописанная запись в конце журнала (сбой посреди записи) отбрасывается.
+// Если снимок потерян или испорчен, журнал учитывается целиком с первой записи.
+//
+// При первом запуске баланс и купленные стили переносятся из save.ini
+// ("coins", "unlocked_styles").
+class CoinLedger : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Вид изменения (пишется в журнал для разбора)
+    enum Kind : quint16 {
+        WinReward = 1,     // награда за победу
+        LossReward = 2,    // утешительная награда за поражение
+        StylePurchase = 3  // покупка стиля (подробность - номер стиля)
+    };
+
+    static CoinLedger& instance();
+
+    qint64 balance() const { return currentBalance; }
+
+    // Начисляет (или списывает при отрицательном amount) монеты
+    void add(qint32 amount, Kind kind, quint16 detail = 0);
+    // Списывает cost, если хватает монет. false - не хватает, ничего не меняется
+    bool spend(qint32 cost, Kind kind, quint16 detail = 0);
+
+    // Стиль, доступный без покупки
+    static const int FREE_STYLE = 1;
+
+    bool isStyleUnlocked(int styleId) const { return styleId == FREE_STYLE || purchased.contains(styleId); }
+    // Покупка стиля одной записью журнала. false - не хватает монет,
+    // стиль уже куплен или его номер не помещается в запись
+    bool buyStyle(int styleId, qint32 cost);
+
+    // Сбрасывает журнал на диск сейчас (вызывается при выходе)
+    void sync();
+
+signals:
+    void balanceChanged(qint64 balance);
+
+private:
+    CoinLedger();
+    ~CoinLedger();
+    CoinLedger(const CoinLedger&) = delete;
+    CoinLedger& operator=(const CoinLedger&) = delete;
+
+    bool loadSnapshot();
+    // Купленные стили из save.ini (сохранения до журнала)
+    void importLegacyStyles();
+    bool writeSnapshot();
+    void replayJournal();
+    void append(qint32 amount, Kind kind, quint16 detail);
+    // Переносит журнал в снимок и очищает его
+    void compact();
+
+    static const int RECORD_SIZE = 16;
+    // Заголовок снимка без списка стилей и контрольной суммы
+    static const int SNAPSHOT_HEADER_SIZE = 20;
+    static const int COMPACT_RECORDS = 1024;
+    static const int SYNC_DELAY_MS = 1000;
+
+    QString snapshotPath;
+    QFile journal;
+    QTimer* syncTimer;
+
+    qint64 currentBalance = 0;
+    QSet<int> purchased; // купленные стили (кроме FREE_STYLE)
+    quint32 lastSequence = 0;     // номер последней записи (в журнале или снимке)
+    quint32 snapshotSequence = 0; // номер последней записи, учтенной в снимке
+    int journalRecords = 0;
+};
+
+#endif // COINLEDGER_H
@@ -14,6 +14,9 @@ public:
     virtual int getGameTime() const = 0;   // Общее время на игру (сек)
     virtual double getCoinMultiplier() const = 0; // Множитель монет
     virtual QString getName() const = 0;
+
+    // Ошибок до проигрыша. Одно значение для окна игры, симуляции и решателя
+    virtual int getMaxMistakes() const { return 10; }
 };
 
 // Лёгкая сложность
@@ -52,4 +55,19 @@ public:
     QString getName() const override { return "Hard"; }
 };
 
+// Сложность с полем rows x cols (например, для повтора записанной партии).
+// nullptr - такого поля нет ни в одной сложности
+inline GameDifficulty* createDifficultyForBoard(int rows, int cols) {
+    GameDifficulty* candidates[] = { new EasyDifficulty(), new MediumDifficulty(), new HardDifficulty() };
+    GameDifficulty* found = nullptr;
+    for (GameDifficulty* difficulty : candidates) {
+        if (!found && difficulty->getRows() == rows && difficulty->getCols() == cols) {
+            found = difficulty;
+        } else {
+            delete difficulty;
+        }
+    }
+    return found;
+}
+
 #endif // DIFFICULTIES_H
@@ -1,4 +1,6 @@
 #include "difficultyselectionwindow.h"
+#include "imagecache.h"
+#include "settingsstore.h"
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QLabel>
@@ -9,6 +11,10 @@ DifficultySelectionWindow::DifficultySelectionWindow(QWidget *parent)
 {
     setupUI();
     applyStyles();
+
+    // Пока игрок выбирает сложность, в фоне декодируем картинки выбранного стиля,
+    // чтобы предпросмотр карт в игре появился сразу
+    ImageCache::instance().prefetch(SettingsStore::instance().value("current_style", 1).toInt(), devicePixelRatioF());
 }
 
 DifficultySelectionWindow::~DifficultySelectionWindow()
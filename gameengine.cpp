@@ -0,0 +1,153 @@
+#include "gameengine.h"
+#include <cassert>
+
+GameEngine::GameEngine(const GameRules& rules)
+    : gameRules(rules)
+{
+    // Поле из пар и помещается в массив движка
+    assert(rules.rows * rules.cols % 2 == 0);
+    assert(rules.rows * rules.cols <= MAX_CARDS);
+}
+
+void GameEngine::deal() {
+    count = gameRules.rows * gameRules.cols;
+    for (int i = 0; i < count; ++i) {
+        cards[i] = static_cast<CardId>(i / 2 + 1); // 1, 1, 2, 2, 3, 3, ...
+    }
+}
+
+void GameEngine::newGame(std::uint64_t seed) {
+    deal();
+    shuffle(seed);
+    startPreview();
+}
+
+void GameEngine::shuffle(std::uint64_t seed) {
+    gameSeed = seed;
+    // Тасование Фишера-Йетса на своем генераторе: результат зависит только от зерна
+    SplitMix64 rng(seed);
+    for (int i = count - 1; i > 0; --i) {
+        int j = static_cast<int>(rng.below(static_cast<std::uint32_t>(i + 1)));
+        std::swap(cards[i], cards[j]);
+    }
+}
+
+void GameEngine::startPreview() {
+    // Маски пар строятся один раз на партию
+    pairMasks.fill(0);
+    for (int i = 0; i < count; ++i) {
+        pairMasks[cards[i]] |= cardBit(i);
+    }
+
+    allMask = count == MAX_CARDS ? ~CardMask(0) : cardBit(count) - 1;
+    faceUpMask = allMask; // все карты открыты для запоминания
+    matchedMask = 0;
+    selectedMask = 0;
+    lockedMask = allMask;
+
+    attemptCount = 0;
+    mistakeCount = 0;
+    matchedCount = 0;
+    secondsLeft = gameRules.gameTime;
+
+    if (listener) {
+        listener->attemptMade(attemptCount);
+        listener->timeChanged(secondsLeft);
+    }
+    setPhase(GamePhase::Preview);
+}
+
+void GameEngine::finishPreview() {
+    if (currentPhase != GamePhase::Preview) return;
+
+    faceUpMask = 0;
+    lockedMask = 0;
+    setPhase(GamePhase::Playing);
+}
+
+bool GameEngine::canFlip(int index) const {
+    return index >= 0 && index < count && (flippableCards() & cardBit(index));
+}
+
+bool GameEngine::flip(int index) {
+    if (!canFlip(index)) return false;
+
+    const CardMask bit = cardBit(index);
+    faceUpMask |= bit;
+    selectedMask |= bit;
+    if (listener) listener->cardRevealed(index);
+
+    if (cardsIn(selectedMask) < 2) return true;
+
+    // Открыто две карты - это попытка
+    attemptCount++;
+    if (listener) listener->attemptMade(attemptCount);
+
+    const int first = lowestCard(selectedMask);
+    const int second = lowestCard(selectedMask & ~cardBit(first));
+
+    if (pairCards(first) != selectedMask) {
+        mistakeCount++;
+        if (mistakeCount >= gameRules.maxMistakes) {
+            lose(LossReason::TooManyMistakes);
+            return true;
+        }
+        // Карты остаются открытыми, пока владелец не вызовет flipBack()
+        lockedMask = allMask;
+        setPhase(GamePhase::Mismatch);
+        return true;
+    }
+
+    matchedMask |= selectedMask;
+    selectedMask = 0;
+    matchedCount++;
+    if (listener) listener->pairMatched(first, second);
+
+    if (allMatched()) {
+        win();
+    }
+    return true;
+}
+
+void GameEngine::flipBack() {
+    if (currentPhase != GamePhase::Mismatch) return;
+
+    CardMask hidden = selectedMask;
+    faceUpMask &= ~hidden;
+    selectedMask = 0;
+    lockedMask = 0;
+    for (; hidden; hidden &= hidden - 1) {
+        if (listener) listener->cardHidden(lowestCard(hidden));
+    }
+    setPhase(GamePhase::Playing);
+}
+
+void GameEngine::tick() {
+    // Время идет только во время игры (в том числе пока видна неверная пара)
+    if (currentPhase != GamePhase::Playing && currentPhase != GamePhase::Mismatch) return;
+
+    secondsLeft--;
+    if (listener) listener->timeChanged(secondsLeft);
+
+    if (secondsLeft <= 0) {
+        lose(LossReason::TimeOut);
+    }
+}
+
+void GameEngine::setPhase(GamePhase phase) {
+    if (currentPhase == phase) return;
+    currentPhase = phase;
+    if (listener) listener->phaseChanged(phase);
+}
+
+void GameEngine::win() {
+    lockedMask = allMask;
+    setPhase(GamePhase::Won);
+    if (listener) listener->victory(attemptCount);
+}
+
+void GameEngine::lose(LossReason reason) {
+    lockedMask = allMask;
+    setPhase(GamePhase::Lost);
+    if (listener) listener->defeat(reason, matchedCount);
+}
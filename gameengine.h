@@ -0,0 +1,219 @@
+#ifndef GAMEENGINE_H
+#define GAMEENGINE_H
+
+#include <array>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Номер картинки на карте (1..pairCount). Байта хватает с запасом:
+// на самом большом поле 12 пар
+using CardId = std::uint8_t;
+
+// Набор карт поля: бит i - карта с индексом i
+using CardMask = std::uint64_t;
+
+inline CardMask cardBit(int index) { return CardMask(1) << index; }
+
+// Индекс младшей карты в наборе (набор не пустой)
+inline int lowestCard(CardMask mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+// Количество карт в наборе
+inline int cardsIn(CardMask mask)
+{
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(mask));
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+// Правила одной партии (берутся из сложности)
+struct GameRules {
+    int rows = 4;
+    int cols = 4;
+    int gameTime = 90;     // общее время на игру (сек)
+    int maxMistakes = 10;  // ошибок до проигрыша
+};
+
+// Этапы партии. Переходы:
+//   Idle -> Preview (newGame) -> Playing (finishPreview)
+//   Playing -> Mismatch (открыта неверная пара) -> Playing (flipBack)
+//   Playing/Mismatch -> Won / Lost
+enum class GamePhase {
+    Idle,     // партия еще не начата
+    Preview,  // все карты открыты для запоминания
+    Playing,  // можно открывать карты
+    Mismatch, // открыта неверная пара, ждем flipBack()
+    Won,
+    Lost
+};
+
+enum class LossReason {
+    TimeOut,
+    TooManyMistakes
+};
+
+// Генератор splitmix64: 64-битное состояние, одинаковая последовательность
+// на любой платформе и с любой стандартной библиотекой (в отличие от
+// std::shuffle и распределений из <random>). По зерну партии
+// всегда получается одна и та же раскладка.
+class SplitMix64
+{
+public:
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Число от 0 до bound - 1 (умножение старших 32 бит, без деления)
+    std::uint32_t below(std::uint32_t bound) {
+        return static_cast<std::uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+
+private:
+    std::uint64_t state;
+};
+
+// Подписчик на события движка (окно игры, симуляция, тесты).
+// Все методы вызываются синхронно изнутри вызовов GameEngine.
+// При смене этапа (phaseChanged) могло измениться состояние сразу
+// всех карт - актуальные наборы берутся из faceUpCards() и т.д.
+class GameEngineListener {
+public:
+    virtual ~GameEngineListener() = default;
+
+    virtual void cardRevealed(int index) { (void)index; }
+    virtual void cardHidden(int index) { (void)index; }
+    virtual void pairMatched(int first, int second) { (void)first; (void)second; }
+    virtual void attemptMade(int attempts) { (void)attempts; }
+    virtual void timeChanged(int secondsLeft) { (void)secondsLeft; }
+    virtual void phaseChanged(GamePhase phase) { (void)phase; }
+    virtual void victory(int attempts) { (void)attempts; }
+    virtual void defeat(LossReason reason, int matchedPairs) { (void)reason; (void)matchedPairs; }
+};
+
+// Правила игры "Найди пару" без интерфейса и таймеров.
+//
+// Поле - плоский массив номеров картинок (1..pairCount), по два одинаковых,
+// индекс карты = row * cols + col. Массив фиксированного размера
+// (MAX_CARDS байт - одна кэш-линия), живет внутри движка без выделений памяти.
+// Состояние карт - битовые маски CardMask (открыта, найдена, выбрана в этом ходу),
+// поэтому блокировка поля, проверка "все найдены" и подсказки - пара
+// логических операций над 64-битными словами, без обхода поля.
+// Время движок сам не отсчитывает: владелец
+// вызывает tick() раз в секунду, finishPreview() по окончании показа
+// и flipBack() после паузы на неверной паре. Поэтому движок можно гонять
+// без окна и без ожидания - в симуляции, бенчмарках и тестах.
+class GameEngine
+{
+public:
+    // Больше карт на поле не бывает (самое большое поле - 6x4).
+    // Ровно столько бит в CardMask
+    static constexpr int MAX_CARDS = 64;
+
+    explicit GameEngine(const GameRules& rules = GameRules());
+
+    void setListener(GameEngineListener* listener) { this->listener = listener; }
+    const GameRules& rules() const { return gameRules; }
+
+    // Новая партия: раскладывает карты, перемешивает их по зерну seed
+    // и открывает для запоминания. Одно и то же зерно - одна и та же раскладка
+    void newGame(std::uint64_t seed);
+    std::uint64_t seed() const { return gameSeed; }
+
+    // Конец показа: карты закрываются, начинается игра
+    void finishPreview();
+
+    // Открыть карту. Возвращает false, если сейчас ее открыть нельзя
+    bool flip(int index);
+
+    // Закрыть неверную пару и продолжить игру
+    void flipBack();
+
+    // Прошла секунда игрового времени
+    void tick();
+
+    // --- Состояние ---
+    GamePhase phase() const { return currentPhase; }
+    int rows() const { return gameRules.rows; }
+    int cols() const { return gameRules.cols; }
+    int cardCount() const { return count; }
+    int pairCount() const { return count / 2; }
+
+    CardId cardAt(int index) const { return cards[index]; }
+    // Номера картинок всех карт подряд (cardCount() штук)
+    const CardId* cardData() const { return cards.data(); }
+
+    // --- Наборы карт ---
+    CardMask allCards() const { return allMask; }
+    // Открытые картинкой вверх (в том числе найденные)
+    CardMask faceUpCards() const { return faceUpMask; }
+    CardMask matchedCards() const { return matchedMask; }
+    // Открытые в текущем ходу (0, 1 или 2 карты)
+    CardMask selectedCards() const { return selectedMask; }
+    // Карты, которые можно открыть прямо сейчас (пусто, пока поле заблокировано)
+    CardMask flippableCards() const { return allMask & ~(faceUpMask | lockedMask); }
+    // Обе карты с той же картинкой, что у карты index
+    CardMask pairCards(int index) const { return pairMasks[cards[index]]; }
+
+    bool isFaceUp(int index) const { return faceUpMask & cardBit(index); }
+    bool isMatched(int index) const { return matchedMask & cardBit(index); }
+    bool canFlip(int index) const;
+    bool allMatched() const { return matchedMask == allMask; }
+    // Вторая карта пары для карты index
+    int twinOf(int index) const { return lowestCard(pairCards(index) & ~cardBit(index)); }
+
+    int attempts() const { return attemptCount; }
+    int mistakes() const { return mistakeCount; }
+    int matchedPairs() const { return matchedCount; }
+    int timeLeft() const { return secondsLeft; }
+
+private:
+    void deal();
+    void shuffle(std::uint64_t seed);
+    void startPreview();
+    void setPhase(GamePhase phase);
+    void win();
+    void lose(LossReason reason);
+
+    GameRules gameRules;
+    GameEngineListener* listener = nullptr;
+
+    std::array<CardId, MAX_CARDS> cards{}; // номер картинки на каждой карте
+    int count = 0;                         // карт на поле
+    std::uint64_t gameSeed = 0;            // зерно текущей раскладки
+
+    // Пары карт по номеру картинки (заполняется после перемешивания)
+    std::array<CardMask, MAX_CARDS / 2 + 1> pairMasks{};
+
+    CardMask allMask = 0;      // все карты поля
+    CardMask faceUpMask = 0;   // открытые
+    CardMask matchedMask = 0;  // найденные пары
+    CardMask selectedMask = 0; // открытые в текущем ходу
+    CardMask lockedMask = 0;   // заблокированные: всё поле на время показа, паузы и после конца
+
+    GamePhase currentPhase = GamePhase::Idle;
+    int attemptCount = 0;
+    int mistakeCount = 0;
+    int matchedCount = 0;
+    int secondsLeft = 0;
+};
+
+#endif // GAMEENGINE_H
@@ -0,0 +1,255 @@
+#include "gamehistory.h"
+#include "settingsstore.h"
+#include <QDataStream>
+#include <QSaveFile>
+#include <QtEndian>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[4] = {'M', 'M', 'H', 'S'};
+const quint16 VERSION = 1;
+
+void encode(const GameRecord& record, uchar* out)
+{
+    memset(out, 0, 32);
+    qToLittleEndian<qint64>(record.finishedAt, out);
+    qToLittleEndian<quint64>(record.seed, out + 8);
+    qToLittleEndian<quint32>(record.timeMs, out + 16);
+    qToLittleEndian<quint16>(record.styleId, out + 20);
+    qToLittleEndian<quint16>(record.moves, out + 22);
+    out[24] = record.rows;
+    out[25] = record.cols;
+    out[26] = record.mistakes;
+    out[27] = record.matchedPairs;
+    out[28] = static_cast<uchar>(record.outcome);
+}
+
+GameRecord decode(const uchar* data)
+{
+    GameRecord record;
+    record.finishedAt = qFromLittleEndian<qint64>(data);
+    record.seed = qFromLittleEndian<quint64>(data + 8);
+    record.timeMs = qFromLittleEndian<quint32>(data + 16);
+    record.styleId = qFromLittleEndian<quint16>(data + 20);
+    record.moves = qFromLittleEndian<quint16>(data + 22);
+    record.rows = data[24];
+    record.cols = data[25];
+    record.mistakes = data[26];
+    record.matchedPairs = data[27];
+    record.outcome = static_cast<GameOutcome>(data[28]);
+    return record;
+}
+
+} // namespace
+
+// Итоги пишутся через QDataStream (QMap и QVector он сохраняет сам)
+static QDataStream& operator<<(QDataStream& out, const BestGame& best)
+{
+    return out << best.timeMs << best.moves << best.finishedAt;
+}
+
+static QDataStream& operator>>(QDataStream& in, BestGame& best)
+{
+    return in >> best.timeMs >> best.moves >> best.finishedAt;
+}
+
+static QDataStream& operator<<(QDataStream& out, const HistoryStats& stats)
+{
+    return out << stats.games << stats.wins << stats.totalWinMoves
+               << stats.currentStreak << stats.bestStreak << stats.leaderboard;
+}
+
+static QDataStream& operator>>(QDataStream& in, HistoryStats& stats)
+{
+    return in >> stats.games >> stats.wins >> stats.totalWinMoves
+              >> stats.currentStreak >> stats.bestStreak >> stats.leaderboard;
+}
+
+GameHistory& GameHistory::instance() {
+    static GameHistory history;
+    return history;
+}
+
+GameHistory::GameHistory()
+    : file(SettingsStore::dataDir() + "/history.db")
+    , statsPath(SettingsStore::dataDir() + "/history.stats")
+{
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Не удалось открыть историю партий" << file.fileName() << file.errorString();
+        return;
+    }
+
+    uchar header[HEADER_SIZE] = {};
+    if (file.size() == 0) {
+        memcpy(header, MAGIC, 4);
+        qToLittleEndian<quint16>(VERSION, header + 4);
+        qToLittleEndian<quint16>(RECORD_SIZE, header + 6);
+        file.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+        file.flush();
+    } else if (file.read(reinterpret_cast<char*>(header), HEADER_SIZE) != HEADER_SIZE
+               || memcmp(header, MAGIC, 4) != 0
+               || qFromLittleEndian<quint16>(header + 4) != VERSION
+               || qFromLittleEndian<quint16>(header + 6) != RECORD_SIZE) {
+        qWarning() << "История партий другой версии или повреждена, запись отключена" << file.fileName();
+        file.close();
+        return;
+    }
+
+    // Недописанная запись в конце (сбой при записи) отбрасывается
+    qint64 records = (file.size() - HEADER_SIZE) / RECORD_SIZE;
+    if (HEADER_SIZE + records * RECORD_SIZE != file.size()) {
+        file.resize(HEADER_SIZE + records * RECORD_SIZE);
+    }
+    recordCount = int(records);
+    loadedCount = recordCount;
+    writable = true;
+    writer.setMaxThreadCount(1);
+
+    if (!loadStats() || statsRecords > recordCount) {
+        statsRecords = 0;
+        totalStats = HistoryStats();
+        perBoard.clear();
+    }
+
+    // Итоги догоняют файл: обычно новых записей нет или их несколько
+    if (statsRecords < recordCount) {
+        for (int i = statsRecords; i < recordCount; ++i) {
+            GameRecord game = record(i);
+            addToStats(totalStats, game);
+            addToStats(perBoard[boardKey(game.rows, game.cols)], game);
+        }
+        statsRecords = recordCount;
+        saveStats();
+    }
+}
+
+GameHistory::~GameHistory() {
+    writer.waitForDone();
+    unmap();
+}
+
+void GameHistory::append(const GameRecord& game) {
+    if (!writable) return;
+
+    QByteArray data(RECORD_SIZE, '\0');
+    encode(game, reinterpret_cast<uchar*>(data.data()));
+
+    // Дописывание идет через свой QFile в потоке записи,
+    // GUI-поток только читает начало файла
+    const QString path = file.fileName();
+    writer.start([path, data]() {
+        QFile out(path);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Append)
+            || out.write(data) != data.size() || !out.flush()) {
+            qWarning() << "Не удалось дописать историю партий" << path << out.errorString();
+        }
+    });
+
+    appended.append(game);
+    recordCount++;
+
+    addToStats(totalStats, game);
+    addToStats(perBoard[boardKey(game.rows, game.cols)], game);
+    statsRecords = recordCount;
+    saveStats();
+}
+
+GameRecord GameHistory::record(int index) {
+    if (index < 0 || index >= recordCount) return GameRecord();
+    if (index >= loadedCount) return appended[index - loadedCount];
+
+    const qint64 offset = HEADER_SIZE + qint64(index) * RECORD_SIZE;
+    if (const uchar* data = mapped()) {
+        return decode(data + offset);
+    }
+
+    // Отобразить не удалось (например, нет адресного пространства) - читаем с диска
+    uchar data[RECORD_SIZE];
+    file.seek(offset);
+    if (file.read(reinterpret_cast<char*>(data), RECORD_SIZE) != RECORD_SIZE) return GameRecord();
+    return decode(data);
+}
+
+HistoryStats GameHistory::boardStats(int rows, int cols) const {
+    return perBoard.value(boardKey(rows, cols));
+}
+
+void GameHistory::addToStats(HistoryStats& stats, const GameRecord& game) {
+    stats.games++;
+    if (!game.won()) {
+        stats.currentStreak = 0;
+        return;
+    }
+
+    stats.wins++;
+    stats.totalWinMoves += game.moves;
+    stats.currentStreak++;
+    stats.bestStreak = qMax(stats.bestStreak, stats.currentStreak);
+
+    // Таблица рекордов: быстрее - выше, при равном времени - меньше ходов
+    BestGame best;
+    best.timeMs = game.timeMs;
+    best.moves = game.moves;
+    best.finishedAt = game.finishedAt;
+    auto position = std::upper_bound(stats.leaderboard.begin(), stats.leaderboard.end(), best,
+                                     [](const BestGame& a, const BestGame& b) {
+                                         return a.timeMs != b.timeMs ? a.timeMs < b.timeMs : a.moves < b.moves;
+                                     });
+    if (position - stats.leaderboard.begin() < LEADERBOARD_SIZE) {
+        stats.leaderboard.insert(position, best);
+        if (stats.leaderboard.size() > LEADERBOARD_SIZE) stats.leaderboard.removeLast();
+    }
+}
+
+const uchar* GameHistory::mapped() {
+    if (map || !file.isOpen() || loadedCount == 0) return map;
+    // Записи, дописанные потом, в отображение не входят - оно не устаревает
+    map = file.map(0, HEADER_SIZE + qint64(loadedCount) * RECORD_SIZE);
+    return map;
+}
+
+void GameHistory::unmap() {
+    if (map) {
+        file.unmap(map);
+        map = nullptr;
+    }
+}
+
+bool GameHistory::loadStats() {
+    QFile statsFile(statsPath);
+    if (!statsFile.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&statsFile);
+    quint32 version = 0;
+    qint32 records = 0;
+    in >> version;
+    if (version != STATS_VERSION) return false;
+    in >> records >> totalStats >> perBoard;
+    if (in.status() != QDataStream::Ok) return false;
+
+    statsRecords = records;
+    return true;
+}
+
+void GameHistory::saveStats() {
+    // Итоги - несколько сотен байт, снимок копируется, файл пишется в фоне
+    const QString path = statsPath;
+    const qint32 records = statsRecords;
+    const HistoryStats total = totalStats;
+    const QMap<quint16, HistoryStats> boards = perBoard;
+    writer.start([path, records, total, boards]() {
+        QSaveFile statsFile(path);
+        if (!statsFile.open(QIODevice::WriteOnly)) {
+            qWarning() << "Не удалось сохранить итоги истории" << path;
+            return;
+        }
+        QDataStream out(&statsFile);
+        out << STATS_VERSION << records << total << boards;
+        if (!statsFile.commit()) {
+            qWarning() << "Не удалось сохранить итоги истории" << path << statsFile.errorString();
+        }
+    });
+}
@@ -0,0 +1,123 @@
+#ifndef GAMEHISTORY_H
+#define GAMEHISTORY_H
+
+#include <QFile>
+#include <QMap>
+#include <QVector>
+#include <QThreadPool>
+
+// Чем закончилась партия
+enum class GameOutcome : quint8 {
+    Won = 0,
+    TimeOut = 1,        // вышло время
+    TooManyMistakes = 2 // слишком много ошибок
+};
+
+// Одна сыгранная партия
+struct GameRecord {
+    qint64 finishedAt = 0; // мс от 1970 (QDateTime::currentMSecsSinceEpoch)
+    quint64 seed = 0;      // зерно раскладки (партию можно повторить)
+    quint32 timeMs = 0;    // игровое время от конца показа до конца партии
+    quint16 styleId = 0;
+    quint16 moves = 0;
+    quint8 rows = 0;
+    quint8 cols = 0;
+    quint8 mistakes = 0;
+    quint8 matchedPairs = 0;
+    GameOutcome outcome = GameOutcome::Won;
+
+    bool won() const { return outcome == GameOutcome::Won; }
+};
+
+// Лучшая победа для таблицы рекордов
+struct BestGame {
+    quint32 timeMs = 0;
+    quint16 moves = 0;
+    qint64 finishedAt = 0;
+};
+
+// Итоги по одному полю (сложности) или по всем партиям
+struct HistoryStats {
+    quint32 games = 0;
+    quint32 wins = 0;
+    quint64 totalWinMoves = 0;  // для среднего числа ходов в победах
+    quint32 currentStreak = 0;  // побед подряд сейчас
+    quint32 bestStreak = 0;
+    QVector<BestGame> leaderboard; // самые быстрые победы, по возрастанию времени
+
+    double winRate() const { return games ? double(wins) / games : 0.0; }
+    double averageWinMoves() const { return wins ? double(totalWinMoves) / wins : 0.0; }
+};
+
+// История всех партий игрока.
+//
+// Файл history.db рядом с exe: заголовок HEADER_SIZE байт ("MMHS", версия,
+// размер записи) и записи по RECORD_SIZE байт подряд, только дописываются.
+// Для чтения файл отображается в память (QFile::map), запись с номером i
+// читается без поиска и разбора остальных. Партии этого запуска читаются
+// из памяти, поэтому отображение не меняется, пока файл растет.
+//
+// Итоги (HistoryStats) не пересчитываются по всему файлу: каждая новая
+// партия добавляется к ним сразу, а сами итоги хранятся в history.stats
+// вместе с числом учтенных записей. При запуске дочитываются только
+// записи после этого числа, поэтому окно статистики открывается сразу
+// при любом размере истории.
+//
+// Диск трогает только поток записи (как у SettingsStore): в конце партии
+// GUI-поток обновляет итоги в памяти и отдает потоку запись и снимок итогов.
+// Запись партии всегда идет раньше итогов, которые ее учитывают.
+class GameHistory
+{
+public:
+    static const int LEADERBOARD_SIZE = 10;
+
+    static GameHistory& instance();
+
+    void append(const GameRecord& record);
+
+    int count() const { return recordCount; }
+    // Запись с номером index (0 - самая старая)
+    GameRecord record(int index);
+
+    const HistoryStats& overall() const { return totalStats; }
+    // Итоги по полю rows x cols (пустые, если на нем не играли)
+    HistoryStats boardStats(int rows, int cols) const;
+
+private:
+    GameHistory();
+    ~GameHistory();
+    GameHistory(const GameHistory&) = delete;
+    GameHistory& operator=(const GameHistory&) = delete;
+
+    static quint16 boardKey(int rows, int cols) { return quint16(rows << 8 | cols); }
+    static void addToStats(HistoryStats& stats, const GameRecord& record);
+
+    // Отображает в память записи, которые были в файле при запуске
+    const uchar* mapped();
+    void unmap();
+
+    bool loadStats();
+    // Отдает снимок итогов потоку записи
+    void saveStats();
+
+    static const int HEADER_SIZE = 16;
+    static const int RECORD_SIZE = 32;
+    static const quint32 STATS_VERSION = 1;
+
+    QFile file;
+    QString statsPath;
+    bool writable = false;
+    int recordCount = 0;
+    int loadedCount = 0;           // записей в файле при запуске
+    QVector<GameRecord> appended;  // партии этого запуска (записи loadedCount и дальше)
+    uchar* map = nullptr;
+
+    // Один поток записи: партии и итоги пишутся строго по порядку
+    QThreadPool writer;
+
+    int statsRecords = 0; // сколько записей учтено в итогах
+    HistoryStats totalStats;
+    QMap<quint16, HistoryStats> perBoard;
+};
+
+#endif // GAMEHISTORY_H
@@ -0,0 +1,70 @@
+#include "gamescheduler.h"
+#include <QTimer>
+
+GameScheduler::GameScheduler(QObject *parent)
+    : QObject(parent)
+    , timer(new QTimer(this))
+{
+    deadlines.fill(-1);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::CoarseTimer);
+    connect(timer, &QTimer::timeout, this, &GameScheduler::runDue);
+    clock.start();
+}
+
+void GameScheduler::restart() {
+    cancelAll();
+    clock.restart();
+}
+
+void GameScheduler::scheduleAt(Task task, qint64 timeMs) {
+    deadlines[task] = qMax<qint64>(0, timeMs);
+    rearm();
+}
+
+void GameScheduler::cancel(Task task) {
+    deadlines[task] = -1;
+    rearm();
+}
+
+void GameScheduler::cancelAll() {
+    deadlines.fill(-1);
+    rearm();
+}
+
+void GameScheduler::runDue() {
+    // Обработчик может назначить новые задачи (и снова просроченные, если
+    // поток долго спал) - они выполнятся в этом же цикле
+    dispatching = true;
+    for (;;) {
+        const qint64 now = elapsed();
+        int next = -1;
+        for (int task = 0; task < TaskCount; ++task) {
+            if (deadlines[task] >= 0 && deadlines[task] <= now
+                && (next < 0 || deadlines[task] < deadlines[next])) {
+                next = task;
+            }
+        }
+        if (next < 0) break;
+
+        const qint64 deadline = deadlines[next];
+        deadlines[next] = -1;
+        emit due(static_cast<Task>(next), deadline);
+    }
+    dispatching = false;
+    rearm();
+}
+
+void GameScheduler::rearm() {
+    if (dispatching) return;
+
+    qint64 nearest = -1;
+    for (qint64 deadline : deadlines) {
+        if (deadline >= 0 && (nearest < 0 || deadline < nearest)) nearest = deadline;
+    }
+    if (nearest < 0) {
+        timer->stop();
+        return;
+    }
+    timer->start(int(qMax<qint64>(0, nearest - elapsed())));
+}
@@ -0,0 +1,63 @@
+#ifndef GAMESCHEDULER_H
+#define GAMESCHEDULER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <array>
+
+class QTimer;
+
+// Все таймеры партии на одном QTimer.
+// Сроки задаются в мс от начала партии по монотонным часам (QElapsedTimer),
+// а не интервалами, поэтому ошибка не накапливается: секундный тик, который
+// переназначается от своего срока (deadline + 1000), срабатывает ровно на целых
+// секундах, даже если поток был занят. Просроченные задачи выполняются сразу
+// при следующем пробуждении, по порядку сроков.
+// Таймер грубый (Qt::CoarseTimer) и заводится только до ближайшего срока,
+// так что окно просыпается не чаще, чем нужно самой игре.
+class GameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Task {
+        PreviewEnd,    // конец показа карт
+        CountdownTick, // очередная секунда игрового времени
+        FlipBack,      // закрыть неверную пару
+        ReplayStep,    // следующее действие записанной партии
+        TaskCount
+    };
+    Q_ENUM(Task)
+
+    explicit GameScheduler(QObject *parent = nullptr);
+
+    // Новая партия: часы с нуля, все задачи сняты
+    void restart();
+    // Мс от начала партии
+    qint64 elapsed() const { return clock.elapsed(); }
+
+    void scheduleAt(Task task, qint64 timeMs);
+    void scheduleIn(Task task, qint64 delayMs) { scheduleAt(task, elapsed() + delayMs); }
+    void cancel(Task task);
+    void cancelAll();
+    bool isScheduled(Task task) const { return deadlines[task] >= 0; }
+
+    // Выполняет все просроченные задачи сейчас, не дожидаясь таймера
+    // (например, перед кликом: время могло кончиться, пока поток был занят)
+    void runDue();
+
+signals:
+    // Срок задачи наступил. deadline - назначенное время (не время вызова)
+    void due(GameScheduler::Task task, qint64 deadline);
+
+private:
+    // Заводит таймер до ближайшего срока
+    void rearm();
+
+    QElapsedTimer clock;
+    std::array<qint64, TaskCount> deadlines; // -1 - задача не назначена
+    QTimer* timer;
+    bool dispatching = false;
+};
+
+#endif // GAMESCHEDULER_H
@@ -0,0 +1,157 @@
+#include "imagecache.h"
+#include "stylecatalog.h"
+
+#include <QThreadPool>
+#include <QDebug>
+
+ImageCache& ImageCache::instance()
+{
+    static ImageCache cache;
+    return cache;
+}
+
+qint64 ImageCache::pixmapBytes(const QPixmap& pixmap)
+{
+    if (pixmap.isNull()) return 0;
+    return qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+ImageCache::Entry* ImageCache::touch(const ImageKey& key)
+{
+    auto it = index.find(key);
+    if (it == index.end()) return nullptr;
+
+    // Переносим в начало списка без копирования
+    entries.splice(entries.begin(), entries, it.value());
+    return &entries.front();
+}
+
+void ImageCache::insert(Entry entry)
+{
+    auto existing = index.find(entry.key);
+    if (existing != index.end()) {
+        used -= existing.value()->bytes;
+        entries.erase(existing.value());
+        index.erase(existing);
+    }
+
+    used += entry.bytes;
+    entries.push_front(std::move(entry));
+    index.insert(entries.front().key, entries.begin());
+    evict();
+}
+
+void ImageCache::evict()
+{
+    // Самую свежую запись оставляем всегда, даже если она одна больше бюджета
+    while (used > budget && entries.size() > 1) {
+        Entry& last = entries.back();
+        used -= last.bytes;
+        index.remove(last.key);
+        entries.pop_back();
+    }
+}
+
+void ImageCache::prefetch(int styleId, qreal devicePixelRatio)
+{
+    const ImageKey key = atlasKey(styleId, devicePixelRatio);
+    if (index.contains(key) || pendingStyles.contains(key)) return;
+    pendingStyles.insert(key);
+
+    // Где лежит атлас, знает каталог стилей (встроенный стиль или внешний пакет)
+    const StyleInfo* style = StyleCatalog::instance().find(styleId);
+    const QString atlasBase = style ? style->atlasBase : QString(":/atlases/%1").arg(styleId);
+
+    // Декодируем в пуле потоков, результат возвращаем в GUI-поток очередью событий
+    QThreadPool::globalInstance()->start([this, styleId, atlasBase, devicePixelRatio]() {
+        StyleAtlas decoded = StyleAtlas::decode(styleId, atlasBase, devicePixelRatio);
+        QMetaObject::invokeMethod(this, [this, decoded]() {
+            onAtlasDecoded(decoded);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ImageCache::onAtlasDecoded(StyleAtlas decoded)
+{
+    const ImageKey key = atlasKey(decoded.styleId(), decoded.devicePixelRatio());
+    pendingStyles.remove(key);
+
+    // QPixmap можно создавать только в GUI-потоке
+    decoded.upload();
+
+    if (decoded.isNull()) {
+        qWarning() << "Не удалось загрузить картинки стиля" << key.styleId;
+        emit styleFailed(key.styleId, key.devicePixelRatio);
+        return;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.atlas = decoded;
+    entry.bytes = decoded.byteSize();
+    insert(std::move(entry));
+
+    emit styleReady(key.styleId, key.devicePixelRatio);
+}
+
+bool ImageCache::isStyleReady(int styleId, qreal devicePixelRatio) const
+{
+    return index.contains(atlasKey(styleId, devicePixelRatio));
+}
+
+StyleAtlas ImageCache::atlas(int styleId, qreal devicePixelRatio)
+{
+    if (Entry* entry = touch(atlasKey(styleId, devicePixelRatio))) {
+        return entry->atlas;
+    }
+
+    prefetch(styleId, devicePixelRatio);
+    return StyleAtlas();
+}
+
+QPixmap ImageCache::cardPixmap(int styleId, int cardId, const QSize& size, qreal devicePixelRatio)
+{
+    StyleAtlas styleAtlas = atlas(styleId, devicePixelRatio);
+    if (styleAtlas.isNull()) {
+        return QPixmap(); // стиль еще декодируется
+    }
+
+    // Карты с одинаковой картинкой делят одну запись кэша
+    ImageKey key{styleId, styleAtlas.canonicalCard(cardId), size, devicePixelRatio};
+    if (Entry* entry = touch(key)) {
+        return entry->pixmap;
+    }
+
+    QPixmap pixmap = styleAtlas.card(cardId);
+    if (pixmap.isNull()) {
+        return pixmap; // пустые картинки не кэшируем
+    }
+
+    // Атлас уже декодирован под этот devicePixelRatio, поэтому обычно
+    // ячейка совпадает с размером в пикселях устройства и масштабировать не нужно
+    QSize deviceSize = size * devicePixelRatio;
+    if (pixmap.width() > deviceSize.width() || pixmap.height() > deviceSize.height()) {
+        pixmap = pixmap.scaled(deviceSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+
+    Entry entry;
+    entry.key = key;
+    entry.pixmap = pixmap;
+    entry.bytes = pixmapBytes(pixmap);
+    insert(std::move(entry));
+    return pixmap;
+}
+
+void ImageCache::setByteBudget(qint64 bytes)
+{
+    budget = bytes;
+    evict();
+}
+
+void ImageCache::clear()
+{
+    entries.clear();
+    index.clear();
+    used = 0;
+}
@@ -0,0 +1,111 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QObject>
+#include <QPixmap>
+#include <QSize>
+#include <QHash>
+#include <QSet>
+#include <list>
+
+#include "styleatlas.h"
+
+// Ключ картинки в кэше: стиль, карта, размер и плотность пикселей экрана.
+// cardId == 0 означает атлас стиля целиком.
+struct ImageKey {
+    int styleId = 0;
+    int cardId = 0;
+    QSize size;
+    qreal devicePixelRatio = 1.0;
+
+    bool operator==(const ImageKey& other) const {
+        return styleId == other.styleId && cardId == other.cardId
+               && size == other.size && devicePixelRatio == other.devicePixelRatio;
+    }
+};
+
+inline size_t qHash(const ImageKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.styleId, key.cardId, key.size.width(), key.size.height(), key.devicePixelRatio);
+}
+
+// Общий для всего приложения кэш картинок карт.
+// Живет, пока живет процесс: новая игра или повторное открытие магазина
+// не декодируют картинки заново. Размер ограничен бюджетом в байтах,
+// при превышении выбрасываются давно не использованные картинки (LRU).
+//
+// PNG декодируются в пуле потоков (QThreadPool), GUI-поток никогда не ждет.
+// Когда стиль готов, отправляется сигнал styleReady.
+//
+// Для каждого devicePixelRatio хранится свой вариант атласа и карт
+// (из @2x/@3x ресурсов), поэтому на HiDPI экранах Qt не растягивает картинки
+// при отрисовке, а переезд окна на другой экран не выбрасывает старые варианты.
+class ImageCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ImageCache& instance();
+
+    // Запускает фоновое декодирование атласа стиля, если его еще нет в кэше
+    void prefetch(int styleId, qreal devicePixelRatio = 1.0);
+
+    // Атлас стиля уже декодирован и лежит в кэше
+    bool isStyleReady(int styleId, qreal devicePixelRatio = 1.0) const;
+
+    // Картинка карты нужного размера. Если стиль еще не готов - вернет пустую
+    // картинку и запустит декодирование (дождитесь сигнала styleReady)
+    QPixmap cardPixmap(int styleId, int cardId, const QSize& size, qreal devicePixelRatio = 1.0);
+
+    // Атлас стиля (пустой, если еще декодируется)
+    StyleAtlas atlas(int styleId, qreal devicePixelRatio = 1.0);
+
+    void setByteBudget(qint64 bytes);
+    qint64 byteBudget() const { return budget; }
+    qint64 bytesUsed() const { return used; }
+
+    void clear();
+
+signals:
+    // Атлас стиля декодирован и доступен через cardPixmap()
+    void styleReady(int styleId, qreal devicePixelRatio);
+    // Атлас стиля прочитать не удалось (например, нет пакета стиля).
+    // В кэш он не попадает: следующий prefetch попробует снова
+    void styleFailed(int styleId, qreal devicePixelRatio);
+
+private:
+    ImageCache() = default;
+    ImageCache(const ImageCache&) = delete;
+    ImageCache& operator=(const ImageCache&) = delete;
+
+    static ImageKey atlasKey(int styleId, qreal devicePixelRatio) {
+        return ImageKey{styleId, 0, QSize(), devicePixelRatio};
+    }
+
+    struct Entry {
+        ImageKey key;
+        QPixmap pixmap;
+        StyleAtlas atlas; // заполнен только для cardId == 0
+        qint64 bytes = 0;
+    };
+
+    // Ищет запись и переносит ее в начало списка (самая свежая)
+    Entry* touch(const ImageKey& key);
+    void insert(Entry entry);
+    void evict();
+
+    // Вызывается в GUI-потоке, когда рабочий поток закончил декодирование
+    void onAtlasDecoded(StyleAtlas atlas);
+
+    static qint64 pixmapBytes(const QPixmap& pixmap);
+
+    std::list<Entry> entries; // в начале - недавно использованные
+    QHash<ImageKey, std::list<Entry>::iterator> index;
+
+    QSet<ImageKey> pendingStyles; // атласы, которые сейчас декодируются
+
+    qint64 budget = 32 * 1024 * 1024; // 32 МБ по умолчанию
+    qint64 used = 0;
+};
+
+#endif // IMAGECACHE_H
@@ -0,0 +1,59 @@
+#include "imageloader.h"
+#include "resourcealiases.h"
+
+#include <QImageReader>
+#include <QImageIOHandler>
+#include <QElapsedTimer>
+
+Q_LOGGING_CATEGORY(lcImages, "memory.images", QtWarningMsg)
+
+static qint64 imageBytes(const QSize& size)
+{
+    // После декодирования PNG получается 32 бита на пиксель
+    return qint64(size.width()) * size.height() * 4;
+}
+
+QImage ImageLoader::read(const QString& path, const QSize& maxSize, DecodeStats* stats)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Одинаковые файлы хранятся в ресурсах один раз (см. ResourceAliases)
+    QImageReader reader(ResourceAliases::resolve(path));
+    // Размер из заголовка файла, сами пиксели еще не читаются
+    const QSize sourceSize = reader.size();
+
+    QSize targetSize = sourceSize;
+    if (!maxSize.isEmpty() && sourceSize.isValid()
+        && (sourceSize.width() > maxSize.width() || sourceSize.height() > maxSize.height())) {
+        targetSize = sourceSize.scaled(maxSize, Qt::KeepAspectRatio);
+        reader.setScaledSize(targetSize);
+    }
+
+    // Если декодер сам не умеет масштабировать, QImageReader на время
+    // создает полноразмерную картинку - учитываем это в пике памяти
+    qint64 peakBytes = imageBytes(targetSize);
+    if (targetSize != sourceSize && !reader.supportsOption(QImageIOHandler::ScaledSize)) {
+        peakBytes += imageBytes(sourceSize);
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qCWarning(lcImages) << "не удалось прочитать" << path << reader.errorString();
+        return image;
+    }
+
+    DecodeStats result;
+    result.path = path;
+    result.sourceSize = sourceSize;
+    result.decodedSize = image.size();
+    result.decodeNs = timer.nsecsElapsed();
+    result.peakBytes = peakBytes;
+
+    qCDebug(lcImages).nospace() << "decode " << path << " " << sourceSize.width() << "x" << sourceSize.height()
+                                << " -> " << image.width() << "x" << image.height()
+                                << " за " << result.decodeNs / 1000 << " мкс, пик " << result.peakBytes / 1024 << " КБ";
+
+    if (stats) *stats = result;
+    return image;
+}
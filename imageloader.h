@@ -0,0 +1,34 @@
+#ifndef IMAGELOADER_H
+#define IMAGELOADER_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QLoggingCategory>
+
+Q_DECLARE_LOGGING_CATEGORY(lcImages)
+
+// Статистика декодирования одной картинки
+struct DecodeStats {
+    QString path;
+    QSize sourceSize;     // размер картинки в файле
+    QSize decodedSize;    // размер после декодирования
+    qint64 decodeNs = 0;  // время декодирования
+    qint64 peakBytes = 0; // максимум памяти под пиксели во время декодирования
+};
+
+// Чтение картинок сразу в нужном размере.
+// Размер в файле узнается по заголовку, и QImageReader::setScaledSize просит
+// декодер сразу выдать уменьшенную картинку. Форматы, которые умеют масштабировать
+// при чтении (JPEG), вообще не создают полноразмерный битмап; для остальных он
+// живет только внутри QImageReader и в кэш не попадает.
+// Включить вывод статистики: QT_LOGGING_RULES="memory.images.debug=true"
+namespace ImageLoader {
+
+// Читает картинку, уменьшая ее так, чтобы она влезла в maxSize (с сохранением пропорций).
+// Пустой maxSize - читать как есть. Можно вызывать из рабочего потока.
+QImage read(const QString& path, const QSize& maxSize, DecodeStats* stats = nullptr);
+
+}
+
+#endif // IMAGELOADER_H
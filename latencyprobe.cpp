@@ -0,0 +1,86 @@
+#include "latencyprobe.h"
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const char* const STAGE_NAMES[LatencyProbe::StageCount] = { "handled", "pixmap", "painted" };
+
+// p-я доля отсортированных значений (ближайший ранг), в миллисекундах
+double percentileMs(const QVector<qint64>& sorted, double p)
+{
+    int rank = qBound(0, int(p * sorted.size() + 0.999999) - 1, int(sorted.size()) - 1);
+    return sorted[rank] / 1e6;
+}
+
+} // namespace
+
+LatencyProbe& LatencyProbe::instance() {
+    static LatencyProbe probe;
+    return probe;
+}
+
+LatencyProbe::LatencyProbe() {
+    logPath = qEnvironmentVariable("MEMORY_LATENCY_LOG");
+    enabled = !logPath.isEmpty();
+    if (enabled) {
+        clock.start();
+        qDebug() << "Замер задержки кликов включен, итоги в" << logPath;
+    }
+}
+
+void LatencyProbe::clickDelivered(int index) {
+    if (!enabled) return;
+    const CardMask bit = cardBit(index);
+    // Повторный клик по той же карте до ее отрисовки начинает замер заново
+    pending |= bit;
+    for (CardMask& stage : reached) stage &= ~bit;
+    clickedAt[index] = clock.nsecsElapsed();
+}
+
+void LatencyProbe::mark(int index, Stage stage) {
+    if (!enabled) return;
+    const CardMask bit = cardBit(index);
+    // Учитываем только первое достижение этапа после клика
+    if (!(pending & bit) || (reached[stage] & bit)) return;
+    reached[stage] |= bit;
+    samples[stage].append(clock.nsecsElapsed() - clickedAt[index]);
+}
+
+void LatencyProbe::paintFinished(CardMask painted) {
+    if (!enabled) return;
+    for (CardMask done = painted & pending; done; done &= done - 1) {
+        mark(lowestCard(done), Painted);
+    }
+    pending &= ~painted;
+}
+
+void LatencyProbe::endSession(const QString& label) {
+    if (!enabled) return;
+
+    QFile file(logPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "Не удалось записать замер задержки в" << logPath;
+    } else {
+        QTextStream out(&file);
+        if (file.size() == 0) {
+            out << "time,session,stage,clicks,p50_ms,p90_ms,p99_ms,max_ms\n";
+        }
+        const QString now = QDateTime::currentDateTime().toString(Qt::ISODate);
+        for (int stage = 0; stage < StageCount; ++stage) {
+            QVector<qint64> sorted = samples[stage];
+            if (sorted.isEmpty()) continue;
+            std::sort(sorted.begin(), sorted.end());
+            out << now << ',' << label << ',' << STAGE_NAMES[stage] << ',' << sorted.size() << ','
+                << percentileMs(sorted, 0.5) << ',' << percentileMs(sorted, 0.9) << ','
+                << percentileMs(sorted, 0.99) << ',' << sorted.last() / 1e6 << '\n';
+        }
+    }
+
+    pending = 0;
+    reached.fill(0);
+    for (QVector<qint64>& stage : samples) stage.clear();
+}
@@ -0,0 +1,58 @@
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include <array>
+
+#include "gameengine.h"
+
+// Замер задержки от клика по карте до ее отрисовки.
+// Включается переменной окружения MEMORY_LATENCY_LOG=<файл>, без нее все вызовы
+// сводятся к одной проверке флага.
+//
+// Для каждого клика отмечается время от доставки события мыши полю (BoardWidget)
+// до каждого этапа:
+//   handled - окно приняло клик (звук запущен, ход передается движку);
+//   pixmap  - при отрисовке картинка карты нарисована из атласа стиля;
+//   painted - закончена отрисовка поля, задевшая эту карту.
+// Время отрисовки до вывода на экран (flush окна) сюда не входит.
+//
+// В конце партии (endSession) по каждому этапу в файл дописывается строка CSV:
+//   время,сессия,этап,кликов,p50_мс,p90_мс,p99_мс,max_мс
+// Файлы разных сборок сравниваются построчно.
+class LatencyProbe
+{
+public:
+    enum Stage { Handled, Pixmap, Painted, StageCount };
+
+    static LatencyProbe& instance();
+
+    bool isEnabled() const { return enabled; }
+
+    // Событие клика по карте доставлено полю
+    void clickDelivered(int index);
+    // Клик по карте дошел до этапа stage (если замер этой карты идет)
+    void mark(int index, Stage stage);
+    // Отрисовка закончена для карт painted - замер для них завершен
+    void paintFinished(CardMask painted);
+
+    // Дописывает итоги партии в файл и начинает новую сессию
+    void endSession(const QString& label);
+
+private:
+    LatencyProbe();
+    LatencyProbe(const LatencyProbe&) = delete;
+    LatencyProbe& operator=(const LatencyProbe&) = delete;
+
+    bool enabled = false;
+    QString logPath;
+    QElapsedTimer clock;
+    CardMask pending = 0;                                 // карты с незавершенным замером
+    std::array<qint64, GameEngine::MAX_CARDS> clickedAt{}; // нс, момент клика по карте
+    std::array<CardMask, StageCount> reached{};           // какие карты уже прошли этап
+    std::array<QVector<qint64>, StageCount> samples;      // задержки сессии (нс) по этапам
+};
+
+#endif // LATENCYPROBE_H
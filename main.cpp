@@ -1,10 +1,73 @@
 #include "mainmenu.h" // Подключаем наше меню
+#include "assetpacks.h"
+#include "stylecatalog.h"
+#include "memorygamewindow.h"
+#include "replaylog.h"
+#include "soundeffects.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QDebug>
+
+// Открывает окно игры с повтором записанной партии (Memory --replay файл.mmrp)
+static bool startReplay(const QString& path, double speed)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Не удалось открыть запись партии" << path;
+        return false;
+    }
+    QByteArray data = file.readAll();
+
+    ReplayLog log;
+    if (!log.deserialize(reinterpret_cast<const std::uint8_t*>(data.constData()), size_t(data.size()))) {
+        qWarning() << "Файл не является записью партии" << path;
+        return false;
+    }
+
+    GameDifficulty* difficulty = createDifficultyForBoard(log.rules().rows, log.rules().cols);
+    if (!difficulty) {
+        qWarning() << "В игре нет сложности с полем" << log.rules().rows << "x" << log.rules().cols;
+        return false;
+    }
+
+    MemoryGameWindow* window = new MemoryGameWindow(difficulty);
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    window->show();
+    return window->playReplay(log, speed);
+}
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    // Если ресурсы лежат во внешних .rcc - подключаем основной пакет (меню и звуки).
+    // Пакеты стилей подключаются позже, при первом использовании
+    AssetPacks::registerCore();
+
+    // Короткие звуки декодируются сразу: первый клик уже не ждет медиаплеер
+    SoundEffects::instance().preload();
+
+    // Дополнительные стили карт из папки styles рядом с exe (читаются только описания)
+    StyleCatalog::instance().scan(QCoreApplication::applicationDirPath() + "/styles");
+
+    // Повтор записанной партии вместо обычного запуска (для разбора жалоб и замеров):
+    //   Memory --replay replays/20250101-120000-000-<зерно>.mmrp --replay-speed 4
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption replayOption("replay", "Показать записанную партию.", "file");
+    QCommandLineOption speedOption("replay-speed", "Скорость повтора (1 - как в игре).", "speed", "1");
+    parser.addOption(replayOption);
+    parser.addOption(speedOption);
+    parser.process(a);
+
+    if (parser.isSet(replayOption)) {
+        if (!startReplay(parser.value(replayOption), parser.value(speedOption).toDouble())) {
+            return 1;
+        }
+        return a.exec();
+    }
+
     MainMenu w; // Создаем экземпляр MainMenu
     w.show();
 
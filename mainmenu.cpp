@@ -1,9 +1,15 @@
 #include "mainmenu.h"
+#include "resourcealiases.h"
 #include "memorygamewindow.h"
 #include "styleswindow.h"
 #include "settingswindow.h"
+#include "statisticswindow.h"
 #include "difficultyselectionwindow.h"
 #include "difficulties.h"
+#include "rewards.h"
+#include "settingsstore.h"
+#include "coinledger.h"
+#include "soundeffects.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -11,42 +17,22 @@
 #include <QPushButton>
 #include <QMessageBox>
 #include <QApplication>
-#include <QSettings>
 #include <QCloseEvent>
 #include <QUrl>
 
 // --- Вспомогательные методы ---
 
-void MainMenu::loadCoins()
-{
-    this->setWindowIcon(QIcon(":/icons/game_icon.ico"));
-    // QSettings позволяет сохранять настройки между запусками программы
-    // "AmNyamm" - имя автора/компании, "MemoryGame" - название игры
-    QString savePath = qApp->applicationDirPath() + "/save.ini";
-    QSettings settings(savePath, QSettings::IniFormat);
-    // Если настройки нет, вернет 1000 по умолчанию
-    coins = settings.value("coins", 1000).toInt();
-}
-
-void MainMenu::saveCoins()
-{
-    QString savePath = qApp->applicationDirPath() + "/save.ini";
-    QSettings settings(savePath, QSettings::IniFormat);
-    settings.setValue("coins", coins); // Записываем значение на диск
-}
-
 void MainMenu::updateCoinLabel()
 {
     if (coinLabel) {
-        // %1 заменится на значение переменной coins
-        coinLabel->setText(QString("Монеты: %1 💰").arg(coins));
+        // %1 заменится на текущий баланс
+        coinLabel->setText(QString("Монеты: %1 💰").arg(CoinLedger::instance().balance()));
     }
 }
 
 void MainMenu::applyAudioSettings()
 {
-    QString savePath = qApp->applicationDirPath() + "/save.ini";
-    QSettings settings(savePath, QSettings::IniFormat);
+    const SettingsStore& settings = SettingsStore::instance();
     bool musicEnabled = settings.value("audio/music_enabled", true).toBool();
 
     // Если музыка включена громкость 0.1, иначе 0.0 (тишина)
@@ -56,28 +42,39 @@ void MainMenu::applyAudioSettings()
     bool soundEnabled = settings.value("audio/sound_enabled", true).toBool();
     float soundVolume = soundEnabled ? 0.8f : 0.0f;
     if (clickAudioOutput) clickAudioOutput->setVolume(soundVolume);
+    SoundEffects::instance().setVolume(soundVolume);
+}
+
+void MainMenu::playClickSound()
+{
+    // Обычно звук уже в памяти (SoundEffects), плеер - если декодировать не удалось
+    if (SoundEffects::instance().play(SoundEffects::ButtonClick)) return;
+    clickSound->setPosition(0); // Перемотка звука в начало
+    clickSound->play();
 }
 
 MainMenu::MainMenu(QWidget *parent)
     : QWidget(parent)
-    , coins(0)
     , menuBGMPlayer(new QMediaPlayer(this))
     , menuAudioOutput(new QAudioOutput(this))
     , clickSound(new QMediaPlayer(this))
     , clickAudioOutput(new QAudioOutput(this))
 {
-    loadCoins();
+    this->setWindowIcon(QIcon(ResourceAliases::resolve(":/icons/game_icon.ico")));
     setupUI();
     applyStyles();
 
+    // Баланс меняется наградами и покупками в магазине - метка обновляется сама
+    connect(&CoinLedger::instance(), &CoinLedger::balanceChanged, this, &MainMenu::updateCoinLabel);
+
     // Настраиваем плеер
     menuBGMPlayer->setAudioOutput(menuAudioOutput);
     // qrc:/ - это путь к ресурсам, встроенным внутрь exe-файла
-    menuBGMPlayer->setSource(QUrl("qrc:/audios/menu_bgm.mp3"));
+    menuBGMPlayer->setSource(ResourceAliases::url("qrc:/audios/menu_bgm.mp3"));
     menuBGMPlayer->setLoops(QMediaPlayer::Infinite); // Бесконечный повтор
 
     clickSound->setAudioOutput(clickAudioOutput);
-    clickSound->setSource(QUrl("qrc:/audios/button_click.mp3"));
+    clickSound->setSource(ResourceAliases::url("qrc:/audios/button_click.mp3"));
 
     applyAudioSettings();
     menuBGMPlayer->play();
@@ -90,14 +87,15 @@ MainMenu::~MainMenu()
 // Вызывается автоматически при нажатии на крестик окна
 void MainMenu::closeEvent(QCloseEvent *event)
 {
-    saveCoins(); // Сохраняем прогресс
+    // Монеты уже в журнале, дописываем его на диск
+    CoinLedger::instance().sync();
     QWidget::closeEvent(event); // Разрешаем закрытие
 }
 
 void MainMenu::setupUI()
 {
     setWindowTitle("Игра на Память - Главное Меню");
-    setFixedSize(450, 600);
+    setFixedSize(450, 680); // Пять кнопок меню
 
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     mainLayout->setContentsMargins(30, 30, 30, 30);
@@ -120,6 +118,10 @@ void MainMenu::setupUI()
     stylesButton->setObjectName("menuButton");
     connect(stylesButton, &QPushButton::clicked, this, &MainMenu::onStylesClicked);
 
+    QPushButton *statisticsButton = new QPushButton("Статистика");
+    statisticsButton->setObjectName("menuButton");
+    connect(statisticsButton, &QPushButton::clicked, this, &MainMenu::onStatisticsClicked);
+
     QPushButton *settingsButton = new QPushButton("Настройки");
     settingsButton->setObjectName("menuButton");
     connect(settingsButton, &QPushButton::clicked, this, &MainMenu::onSettingsClicked);
@@ -134,6 +136,7 @@ void MainMenu::setupUI()
     mainLayout->addSpacing(10);
     mainLayout->addWidget(playButton);
     mainLayout->addWidget(stylesButton);
+    mainLayout->addWidget(statisticsButton);
     mainLayout->addWidget(settingsButton);
     mainLayout->addStretch(1);
     mainLayout->addWidget(exitButton);
@@ -188,8 +191,7 @@ void MainMenu::applyStyles()
 
 void MainMenu::onPlayClicked()
 {
-    clickSound->setPosition(0); // Перемотка звука в начало
-    clickSound->play();
+    playClickSound();
 
     // Создаем окно выбора сложности
     DifficultySelectionWindow *diffWindow = new DifficultySelectionWindow(this);
@@ -218,26 +220,25 @@ void MainMenu::onPlayClicked()
 
 void MainMenu::onStylesClicked()
 {
-    clickSound->setPosition(0);
-    clickSound->play();
+    playClickSound();
 
-    StylesWindow *stylesWindow = new StylesWindow(coins, this);
+    // Покупка списывает монеты через CoinLedger, меню узнает о ней по balanceChanged
+    StylesWindow *stylesWindow = new StylesWindow(this);
     stylesWindow->setAttribute(Qt::WA_DeleteOnClose);
 
-    // Подписываемся на изменение монет, чтобы обновить их в меню сразу после покупки
-    connect(stylesWindow, &StylesWindow::coinsChanged, this, [this](int newCoins) {
-        this->coins = newCoins;
-        this->updateCoinLabel();
-        this->saveCoins();
-    });
-
     stylesWindow->show();
 }
 
+void MainMenu::onStatisticsClicked()
+{
+    playClickSound();
+    StatisticsWindow statisticsWindow(this);
+    statisticsWindow.exec();
+}
+
 void MainMenu::onSettingsClicked()
 {
-    clickSound->setPosition(0);
-    clickSound->play();
+    playClickSound();
     SettingsWindow settingsWindow(this);
     // exec() запускает окно в модальном режиме (блокирует остальные окна пока открыто)
     settingsWindow.exec();
@@ -246,13 +247,11 @@ void MainMenu::onSettingsClicked()
 
 void MainMenu::onGameWon(int moves, double multiplier)
 {
-    // Расчет награды: чем меньше ходов, тем больше монет (но не меньше 500)
-    int baseReward = qMax(500, 1000 - moves * 10);
-    // Умножаем на коэффициент сложности
-    int finalReward = static_cast<int>(baseReward * multiplier);
+    // Расчет награды с учетом коэффициента сложности (см. rewards.h)
+    int finalReward = winReward(moves, multiplier);
 
-    coins += finalReward;
-    saveCoins();
+    // Одна запись в журнал монет
+    CoinLedger::instance().add(finalReward, CoinLedger::WinReward, quint16(moves));
 
     QMessageBox::information(this, "Победа!",
                              QString("Поздравляем! Вы нашли все пары за %1 ходов.\nНаграда: %2 💰")
@@ -262,11 +261,9 @@ void MainMenu::onGameWon(int moves, double multiplier)
 
 void MainMenu::onGameLost(int pairsFound, double multiplier)
 {
-    int baseReward = pairsFound * 50;
-    int finalReward = static_cast<int>(baseReward * multiplier);
+    int finalReward = lossReward(pairsFound, multiplier);
 
-    coins += finalReward;
-    saveCoins();
+    CoinLedger::instance().add(finalReward, CoinLedger::LossReward, quint16(pairsFound));
 
     QMessageBox::information(this, "Поражение",
                              QString("Игра окончена.\nНаграда: %2 💰").arg(pairsFound).arg(finalReward));
@@ -276,7 +273,6 @@ void MainMenu::onGameLost(int pairsFound, double multiplier)
 void MainMenu::onGameWindowClosed()
 {
     this->show(); // Показываем меню снова
-    loadCoins();
     updateCoinLabel();
     menuBGMPlayer->play();
 }
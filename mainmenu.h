@@ -11,7 +11,6 @@
 class QPushButton;
 class QLabel;
 class MemoryGameWindow;
-class QSettings;
 class QCloseEvent;
 class SettingsWindow;
 
@@ -35,6 +34,7 @@ private slots:
     void onPlayClicked();
     void onStylesClicked();
     void onSettingsClicked();
+    void onStatisticsClicked();
 
     // Слот, который вызовется при победе
     void onGameWon(int moves, double multiplier);
@@ -52,16 +52,16 @@ private:
     void setupUI();
     void applyStyles();
 
-    // Функции для работы с сохранениями (монеты)
-    void loadCoins();
-    void saveCoins();
+    // Показывает баланс монет (сами монеты хранит CoinLedger)
     void updateCoinLabel();
 
+    // Звук нажатия кнопки меню
+    void playClickSound();
+
     // --- Переменные класса ---
-    int coins;
     QLabel *coinLabel;
 
-    // Плееры для фоновой музыки и звуков клика
+    // Плееры для фоновой музыки и звука клика (если SoundEffects недоступен)
     QMediaPlayer *menuBGMPlayer;
     QAudioOutput *menuAudioOutput;
     QMediaPlayer *clickSound;
@@ -1,5 +1,12 @@
 #include "memorygamewindow.h"
-#include <QSettings>
+#include "resourcealiases.h"
+#include "imagecache.h"
+#include "stylecatalog.h"
+#include "boardwidget.h"
+#include "latencyprobe.h"
+#include "settingsstore.h"
+#include "gamehistory.h"
+#include "soundeffects.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QMessageBox>
@@ -9,17 +16,34 @@
 #include <QIcon>
 #include <QMap>
 #include <QCoreApplication>
+#include <QEvent>
+#include <QDir>
+#include <QFile>
+#include <QDateTime>
+#include <QThreadPool>
 
 const QString ORGANIZATION_NAME = "AmNyamm";
 const QString APPLICATION_NAME = "MemoryGame";
 
+// Поток записи повторов партий. Один на все окна: записи пишутся по порядку,
+// а пул принадлежит приложению и дожидается их при выходе
+static QThreadPool& replayWriter()
+{
+    static QThreadPool* pool = []() {
+        QThreadPool* writer = new QThreadPool(qApp);
+        writer->setMaxThreadCount(1);
+        return writer;
+    }();
+    return *pool;
+}
+
 // Загружаем настройки звука (вкл/выкл)
 void MemoryGameWindow::applyAudioSettings()
 {
     QCoreApplication::setOrganizationName(ORGANIZATION_NAME);
     QCoreApplication::setApplicationName(APPLICATION_NAME);
 
-    QSettings settings(qApp->applicationDirPath() + "/save.ini", QSettings::IniFormat);
+    const SettingsStore& settings = SettingsStore::instance();
 
     // 1. Музыка
     bool musicEnabled = settings.value("audio/music_enabled", true).toBool();
@@ -34,6 +58,7 @@ void MemoryGameWindow::applyAudioSettings()
     float soundVolume = soundEnabled ? 0.8f : 0.0f;
 
     if (flipAudioOutput) flipAudioOutput->setVolume(soundVolume);
+    SoundEffects::instance().setVolume(soundVolume);
     if (victoryAudioOutput) victoryAudioOutput->setVolume(soundVolume);
     if (defeatAudioOutput) defeatAudioOutput->setVolume(soundVolume);
 }
@@ -50,7 +75,7 @@ MemoryGameWindow::MemoryGameWindow(GameDifficulty* difficulty, QWidget *parent)
     , defeatPlayer(new QMediaPlayer(this))
     , defeatAudioOutput(new QAudioOutput(this))
 {
-    this->setWindowIcon(QIcon(":/icons/game_icon.ico"));
+    this->setWindowIcon(QIcon(ResourceAliases::resolve(":/icons/game_icon.ico")));
     // Берем параметры из переданного объекта сложности
     rows = difficulty->getRows();
     cols = difficulty->getCols();
@@ -58,7 +83,13 @@ MemoryGameWindow::MemoryGameWindow(GameDifficulty* difficulty, QWidget *parent)
     coinMultiplier = difficulty->getCoinMultiplier();
     gameTotalTime = difficulty->getGameTime();
 
-    totalPairs = (rows * cols) / 2; // Количество пар = половина от всех карт
+    // Правила партии живут в движке, окно только показывает его состояние
+    gameRules.rows = rows;
+    gameRules.cols = cols;
+    gameRules.gameTime = gameTotalTime;
+    gameRules.maxMistakes = difficulty->getMaxMistakes();
+    engine = GameEngine(gameRules);
+    engine.setListener(this);
 
     setWindowTitle("Найди Пару!");
 
@@ -70,48 +101,46 @@ MemoryGameWindow::MemoryGameWindow(GameDifficulty* difficulty, QWidget *parent)
 
     setStyleSheet("QMainWindow { background-color: #5f9ea0; }");
 
-    // Таймер основного времени игры
-    gameTimer = new QTimer(this);
-    connect(gameTimer, &QTimer::timeout, this, &MemoryGameWindow::gameTimerTimeout);
-
-    // Таймер для показа карт в начале
-    tempShowTimer = new QTimer(this);
-    tempShowTimer->setSingleShot(true); // Сработает только один раз
-    tempShowTimer->setInterval(memoryTime * 1000); // Переводим секунды в миллисекунды
-    connect(tempShowTimer, &QTimer::timeout, this, &MemoryGameWindow::hideAllCardsTimeout);
-
-    // Таймер для переворота карт обратно при ошибке
-    flipBackTimer = new QTimer(this);
-    flipBackTimer->setSingleShot(true);
-    flipBackTimer->setInterval(1000); // 1 секунда задержки
-    connect(flipBackTimer, &QTimer::timeout, this, &MemoryGameWindow::flipBackTimeout);
+    // Все таймеры партии (показ карт, секунды игры, пауза на неверной паре,
+    // повтор записи) идут от одних монотонных часов и будят окно одним QTimer
+    scheduler = new GameScheduler(this);
+    connect(scheduler, &GameScheduler::due, this, &MemoryGameWindow::onScheduled);
 
     // --- Настройка Аудио ---
     gameBGMPlayer->setAudioOutput(gameAudioOutput);
     gameAudioOutput->setVolume(0.1f);
-    gameBGMPlayer->setSource(QUrl("qrc:/audios/game_bgm.mp3"));
+    gameBGMPlayer->setSource(ResourceAliases::url("qrc:/audios/game_bgm.mp3"));
     gameBGMPlayer->setLoops(QMediaPlayer::Infinite);
 
     flipPlayer->setAudioOutput(flipAudioOutput);
-    flipPlayer->setSource(QUrl("qrc:/audios/card_flip.mp3"));
+    flipPlayer->setSource(ResourceAliases::url("qrc:/audios/card_flip.mp3"));
 
     victoryPlayer->setAudioOutput(victoryAudioOutput);
-    victoryPlayer->setSource(QUrl("qrc:/audios/victory.mp3"));
+    victoryPlayer->setSource(ResourceAliases::url("qrc:/audios/victory.mp3"));
 
     defeatPlayer->setAudioOutput(defeatAudioOutput);
-    defeatPlayer->setSource(QUrl("qrc:/audios/defeat.mp3"));
+    defeatPlayer->setSource(ResourceAliases::url("qrc:/audios/defeat.mp3"));
 
     applyAudioSettings();
 
     // Загружаем сохраненный стиль карт
-    QSettings settings(ORGANIZATION_NAME, APPLICATION_NAME);
-    currentStyleId = settings.value("current_style", 1).toInt();
+    currentStyleId = SettingsStore::instance().value("current_style", 1).toInt();
+    // Обычно стиль уже декодирован (prefetch при выборе сложности), иначе начинаем сейчас
+    cardPixelRatio = devicePixelRatioF();
+    ImageCache::instance().prefetch(currentStyleId, cardPixelRatio);
+
+    // Картинки декодируются в фоне, показываем их по мере готовности
+    connect(&ImageCache::instance(), &ImageCache::styleReady, this, &MemoryGameWindow::onStyleImagesReady);
+    connect(&ImageCache::instance(), &ImageCache::styleFailed, this, &MemoryGameWindow::onStyleImagesFailed);
 
     setupUI();
     startNewGame();
 }
 
 MemoryGameWindow::~MemoryGameWindow() {
+    // Незаконченная партия тоже сохраняется - по ней разбираются жалобы на зависания
+    saveReplay();
+    reportLatency("closed");
     if (gameBGMPlayer->playbackState() == QMediaPlayer::PlayingState) {
         gameBGMPlayer->stop();
     }
@@ -121,25 +150,13 @@ MemoryGameWindow::~MemoryGameWindow() {
     }
 }
 
-// Возвращает CSS для кнопок (цвет и градиент рубашки)
+// Возвращает CSS для кнопки "Новая игра" (в цвет рубашки карт)
 QString MemoryGameWindow::getButtonStyle() {
-    QString gradient;
-    QString borderColor;
-
-    if (currentStyleId == 2) {
-        gradient = "qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #4facfe, stop:1 #00f2fe)";
-        borderColor = "#00c6fb";
-    } else if (currentStyleId == 3) {
-        gradient = "qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #fa709a, stop:1 #fee140)";
-        borderColor = "#fa709a";
-    } else if (currentStyleId == 4) {
-        gradient = "qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 	#ffff99, stop:1 #78866b)";
-        borderColor = "#ffff99";
-    } else {
-        // Дефолтный стиль
-        gradient = "qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 #FFB6F772, stop:1 #FF7ED957)";
-        borderColor = "#FF3F9E2F";
-    }
+    // Цвета рубашки берутся из описания стиля (встроенного или из пакета)
+    const StyleInfo& style = StyleCatalog::instance().styleOrDefault(currentStyleId);
+    QString gradient = QString("qlineargradient(x1:0, y1:0, x2:0, y2:1, stop:0 %1, stop:1 %2)")
+                           .arg(style.backTop.name(QColor::HexArgb), style.backBottom.name(QColor::HexArgb));
+    QString borderColor = style.border.name(QColor::HexArgb);
 
     return QString(
                "QPushButton {"
@@ -187,268 +204,419 @@ void MemoryGameWindow::setupUI() {
 
     mainLayout->addWidget(topPanel);
 
-    // Контейнер для сетки карт
-    QWidget* gridContainer = new QWidget();
-    mainGridLayout = new QGridLayout(gridContainer);
-    mainGridLayout->setContentsMargins(10, 10, 10, 10);
-    mainLayout->addWidget(gridContainer);
+    // Игровое поле: все карты рисует один виджет
+    board = new BoardWidget();
+    board->setCardStyle(StyleCatalog::instance().styleOrDefault(currentStyleId));
+    connect(board, &BoardWidget::cardClicked, this, &MemoryGameWindow::onCardClicked);
+    mainLayout->addWidget(board, 1, Qt::AlignCenter);
 }
 
 void MemoryGameWindow::startNewGame() {
-    gameBGMPlayer->play();
-    gameTimer->stop();
-    tempShowTimer->stop();
-    flipBackTimer->stop();
-
-    // Очищаем сетку от старых кнопок
-    if (mainGridLayout) {
-        QLayoutItem *item;
-        while ((item = mainGridLayout->takeAt(0)) != 0) {
-            if (item->widget()) item->widget()->deleteLater(); // Удаляем виджет
-            delete item; // Удаляем элемент лейаута
-        }
+    // Прошлая партия (в том числе брошенная) остается в записи
+    saveReplay();
+    reportLatency("abandoned");
+
+    if (replaying) {
+        // После просмотра повтора - обычная игра по правилам сложности
+        replaying = false;
+        engine = GameEngine(gameRules);
+        engine.setListener(this);
+        setWindowTitle("Найди Пару!");
     }
 
-    // Пересоздаем массивы для хранения данных
-    buttons.assign(rows, std::vector<QPushButton*>(cols, nullptr));
-    imagePaths.assign(rows, std::vector<std::string>(cols, ""));
-    selectedButtons.clear();
-    loadedImages.clear();
+    // Каждая партия получает свое зерно: по нему и записи действий ее можно повторить
+    resetBoard(QRandomGenerator::global()->generate64());
+    replayLog.start(engine.rules(), engine.seed());
 
-    attempts = 0;
-    mistakes = 0;
-    matchedPairs = 0;
-    timeLeft = gameTotalTime;
-    gameStarted = false;
-
-    attemptsLabel->setText("Попытки: 0");
-    timerLabel->setText(QString("Осталось: %1 сек").arg(timeLeft));
-
-    createGrid();
-    fillImagePaths();
     showAllImagesTemporarily();
 }
 
-void MemoryGameWindow::createGrid() {
-    mainGridLayout->setSpacing(10);
-    QString style = getButtonStyle();
+void MemoryGameWindow::resetBoard(quint64 seed) {
+    gameBGMPlayer->play();
+    // Часы партии с нуля, все сроки прошлой партии сняты
+    scheduler->restart();
 
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            QPushButton* btn = new QPushButton();
-            btn->setFixedSize(100, 100);
-            // Запоминаем координаты кнопки внутри самой кнопки
-            btn->setProperty("row", i);
-            btn->setProperty("col", j);
+    waitingForImages = false;
+    previewShown = false;
 
-            btn->setStyleSheet(style);
+    // Все карты закрыты и неактивны (сначала идет показ).
+    // Поле того же размера не пересоздается, а только сбрасывается
+    board->setBoardSize(rows, cols);
 
-            connect(btn, &QPushButton::clicked, this, &MemoryGameWindow::handleButtonClick);
-            mainGridLayout->addWidget(btn, i, j);
-            buttons[i][j] = btn;
-            btn->setEnabled(false); // Сначала кнопки неактивны (идет показ)
-        }
+    // Движок раскладывает карты по зерну и сообщает новые счетчики (попытки, время).
+    // Поле получает только номера картинок, сами картинки оно берет из кэша при отрисовке
+    engine.newGame(seed);
+    board->setCardIds(engine.cardData());
+}
+
+bool MemoryGameWindow::playReplay(const ReplayLog& log, double speed) {
+    if (log.rules().rows != rows || log.rules().cols != cols) {
+        qWarning() << "Запись партии для поля" << log.rules().rows << "x" << log.rules().cols
+                   << ", а окно открыто для" << rows << "x" << cols;
+        return false;
     }
+    saveReplay();
+
+    replaying = true;
+    replay = log;
+    replayPosition = 0;
+    replaySpeed = speed > 0 ? speed : 1.0;
+    setWindowTitle("Найди Пару! (повтор)");
+
+    // Движок с правилами записи: иначе повтор может разойтись с партией
+    engine = GameEngine(log.rules());
+    engine.setListener(this);
+    resetBoard(log.seed());
+
+    showAllImagesTemporarily();
+    return true;
 }
 
-void MemoryGameWindow::fillImagePaths() {
-    std::vector<std::string> names;
+void MemoryGameWindow::showAllImagesTemporarily() {
+    newGameButton->setEnabled(false);
 
-    // Заполняем список парами картинок
-    for (int n = 0; n < totalPairs; ++n) {
-        int imgIndex = n + 1;
-        std::string path = "://images/" + std::to_string(currentStyleId) + " - image" + std::to_string(imgIndex) + ".png";
-        names.push_back(path);
-        names.push_back(path); // Добавляем дважды (для пары)
+    // Если картинки стиля еще не готовы, поле уже видно (рубашками),
+    // а предпросмотр начнется, когда фоновое декодирование закончится
+    if (!ImageCache::instance().isStyleReady(currentStyleId, cardPixelRatio)) {
+        waitingForImages = true;
+        ImageCache::instance().prefetch(currentStyleId, cardPixelRatio);
+        return;
     }
+    startPreview();
+}
 
-    // Перемешиваем массив случайным образом
-    std::shuffle(names.begin(), names.end(), *QRandomGenerator::global());
+void MemoryGameWindow::startPreview() {
+    waitingForImages = false;
+    previewShown = true;
+    syncBoard();
 
-    // Распределяем перемешанные картинки по сетке
-    int index = 0;
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            imagePaths[i][j] = names[index++];
-        }
+    if (replaying) {
+        // Дальше, включая конец показа, всё идет по записи
+        scheduleReplayEvent();
+        return;
     }
+    // Назначаем конец показа (секунды переводим в миллисекунды)
+    scheduler->scheduleIn(GameScheduler::PreviewEnd, memoryTime * 1000);
 }
 
-void MemoryGameWindow::showImage(QPushButton* btn, const std::string& path) {
-    // Кэшируем загрузку, чтобы не читать файл с диска каждый раз
-    if (loadedImages.find(path) == loadedImages.end()) {
-        loadedImages[path] = QPixmap(QString::fromStdString(path));
+void MemoryGameWindow::onStyleImagesReady(int styleId, qreal devicePixelRatio) {
+    if (styleId != currentStyleId || devicePixelRatio != cardPixelRatio) return;
+
+    // Открытые карты поле дорисовывает само, здесь ждем только начала показа
+    if (waitingForImages) {
+        showAllImagesTemporarily();
     }
+}
 
-    QPixmap originalPixmap = loadedImages[path];
-    if (originalPixmap.isNull()) {
-        btn->setText("Image\nNot Found");
-        return;
+void MemoryGameWindow::onStyleImagesFailed(int styleId, qreal devicePixelRatio) {
+    if (styleId != currentStyleId || devicePixelRatio != cardPixelRatio) return;
+
+    // Картинок не будет - партия идет без них, чтобы игра не ждала вечно.
+    // Следующая партия попробует загрузить стиль снова
+    if (waitingForImages) {
+        startPreview();
     }
-    btn->setText("");
+}
 
-    QSize buttonSize(100, 100);
-    // Масштабируем картинку под размер кнопки
-    QPixmap scaledPixmap = originalPixmap.scaled(buttonSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    QIcon icon(scaledPixmap);
-    btn->setIcon(icon);
-    btn->setIconSize(buttonSize);
+bool MemoryGameWindow::event(QEvent* event) {
+    if (event->type() == QEvent::ScreenChangeInternal
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+        || event->type() == QEvent::DevicePixelRatioChange
+#endif
+        ) {
+        updateDevicePixelRatio();
+    }
+    return QMainWindow::event(event);
 }
 
-void MemoryGameWindow::showAllImagesTemporarily() {
-    newGameButton->setEnabled(false);
-    enableAllButtons(false);
+void MemoryGameWindow::updateDevicePixelRatio() {
+    qreal ratio = devicePixelRatioF();
+    if (qFuzzyCompare(ratio, cardPixelRatio)) return;
+    cardPixelRatio = ratio;
 
-    // Показываем картинки на всех кнопках
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            showImage(buttons[i][j], imagePaths[i][j]);
-        }
+    // Если ждали картинки для старого экрана - ждем теперь для нового
+    if (waitingForImages) {
+        showAllImagesTemporarily();
+        return;
     }
-    // Запускаем таймер, который скроет их
-    tempShowTimer->start();
+
+    // Варианты для нового экрана могут быть уже в кэше (окно возвращается назад),
+    // иначе они декодируются в фоне. Поле перерисуется по сигналу styleReady
+    ImageCache::instance().prefetch(currentStyleId, cardPixelRatio);
 }
 
 void MemoryGameWindow::hideAllCardsTimeout() {
-    // Скрываем картинки (ставим пустую иконку)
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            buttons[i][j]->setIcon(QIcon());
-            buttons[i][j]->setEnabled(true); // Теперь можно нажимать
-        }
-    }
+    scheduler->cancel(GameScheduler::PreviewEnd);
+    // Карты закроются и станут активными через события движка
+    perform(ReplayAction::FinishPreview);
     newGameButton->setEnabled(true);
     startCountdown();
 }
 
 void MemoryGameWindow::startCountdown() {
-    gameStarted = true;
-    gameTimer->start(1000); // Запуск таймера (тик раз в секунду)
+    countdownStart = scheduler->elapsed();
+    // Первый тик через секунду, следующие - от срока предыдущего (см. onScheduled)
+    scheduler->scheduleIn(GameScheduler::CountdownTick, 1000);
 }
 
-void MemoryGameWindow::gameTimerTimeout() {
-    timeLeft--;
-    timerLabel->setText(QString("Осталось: %1 сек").arg(timeLeft));
-
-    if (timeLeft <= 0) {
-        gameTimer->stop();
-        showGameOver("Время вышло!");
+void MemoryGameWindow::onScheduled(GameScheduler::Task task, qint64 deadline) {
+    switch (task) {
+    case GameScheduler::PreviewEnd:
+        hideAllCardsTimeout();
+        break;
+    case GameScheduler::CountdownTick:
+        gameTimerTimeout();
+        // Следующая секунда отсчитывается от назначенного срока, а не от момента вызова,
+        // поэтому под нагрузкой время не растягивается, а пропущенные тики догоняются
+        if (engine.phase() == GamePhase::Playing || engine.phase() == GamePhase::Mismatch) {
+            scheduler->scheduleAt(GameScheduler::CountdownTick, deadline + 1000);
+        }
+        break;
+    case GameScheduler::FlipBack:
+        flipBackTimeout();
+        break;
+    case GameScheduler::ReplayStep:
+        replayTimeout();
+        break;
+    case GameScheduler::TaskCount:
+        break;
     }
 }
 
-void MemoryGameWindow::handleButtonClick() {
-    // Если идет анимация возврата карт или игра не идет - игнорируем клик
-    if (!gameStarted || flipBackTimer->isActive()) return;
+void MemoryGameWindow::gameTimerTimeout() {
+    perform(ReplayAction::Tick);
+}
+
+void MemoryGameWindow::onCardClicked(int index) {
+    // Сначала догоняем просроченные сроки: если поток был занят, время могло
+    // уже кончиться или неверная пара - закрыться
+    scheduler->runDue();
+
+    // Если идет пауза на неверной паре или игра не идет - игнорируем клик
+    if (replaying || !engine.canFlip(index)) return;
+
+    playFlipSound();
 
+    // Этап отмечается до хода: последний клик партии заканчивает ее внутри
+    // perform, и после него сессия замера уже закрыта
+    LatencyProbe::instance().mark(index, LatencyProbe::Handled);
+    perform(ReplayAction::Flip, index);
+}
+
+void MemoryGameWindow::playFlipSound() {
+    // Звук из памяти через микшер SoundEffects: начинается сразу и не обрывает
+    // предыдущий при частых кликах. Плеер - только если декодировать не удалось
+    if (SoundEffects::instance().play(SoundEffects::CardFlip)) return;
     flipPlayer->setPosition(0);
     flipPlayer->play();
+}
 
-    // sender() возвращает указатель на объект, который послал сигнал (нажатую кнопку)
-    QPushButton* btn = qobject_cast<QPushButton*>(sender());
-    if (!btn || !btn->isEnabled()) return;
-
-    // Достаем координаты из свойств кнопки
-    int i = btn->property("row").toInt();
-    int j = btn->property("col").toInt();
-
-    showImage(btn, imagePaths[i][j]);
-    btn->setEnabled(false); // Блокируем нажатую кнопку
-    selectedButtons.push_back(btn);
-
-    // Если открыто 2 карты
-    if (selectedButtons.size() == 2) {
-        attempts++;
-        attemptsLabel->setText(QString("Попытки: %1").arg(attempts));
-
-        QPushButton* btn1 = selectedButtons[0];
-        QPushButton* btn2 = selectedButtons[1];
-
-        int i1 = btn1->property("row").toInt(), j1 = btn1->property("col").toInt();
-        int i2 = btn2->property("row").toInt(), j2 = btn2->property("col").toInt();
-
-        // Если картинки не совпали
-        if (imagePaths[i1][j1] != imagePaths[i2][j2]) {
-            mistakes++;
-            if (mistakes >= MAX_MISTAKES) {
-                gameTimer->stop();
-                showGameOver("Слишком много ошибок!");
-                return;
-            }
-            enableAllButtons(false); // Блокируем всё поле, чтобы игрок не тыкал дальше
-            flipBackTimer->start(); // Ждем секунду перед переворотом обратно
-        } else {
-            // Если совпали
-            matchedPairs++;
-
-            btn1->setEnabled(false);
-            btn2->setEnabled(false);
-
-            // Подсвечиваем совпавшие (зеленым)
-            btn1->setStyleSheet("border: 4px solid blue; background-color: #aaf0aa;");
-            btn2->setStyleSheet("border: 4px solid blue; background-color: #aaf0aa;");
-
-            QSize buttonSize(100, 100);
-            btn1->setIconSize(buttonSize);
-            btn2->setIconSize(buttonSize);
-
-            selectedButtons.clear();
-            if (matchedPairs == totalPairs) {
-                gameTimer->stop();
-                showVictoryScreen();
-            }
-        }
+void MemoryGameWindow::flipBackTimeout() {
+    // Переворачиваем неверную пару обратно рубашкой вверх
+    perform(ReplayAction::FlipBack);
+}
+
+void MemoryGameWindow::perform(ReplayAction action, int index) {
+    ReplayEvent event;
+    event.timeMs = static_cast<quint32>(scheduler->elapsed());
+    event.action = action;
+    event.index = static_cast<quint8>(index);
+
+    // Действие записывается до выполнения: оно может закончить партию,
+    // а запись сохраняется при ее окончании
+    replayLog.add(event.timeMs, event.action, event.index);
+    ReplayLog::apply(engine, event);
+}
+
+void MemoryGameWindow::scheduleReplayEvent() {
+    const std::vector<ReplayEvent>& events = replay.events();
+    if (replayPosition >= events.size()) {
+        // Повтор закончился (или партия была брошена) - можно начать свою игру
+        newGameButton->setEnabled(true);
+        return;
     }
+
+    // Сроки считаются от начала повтора, а не от предыдущего шага: так повтор
+    // не отстает от записи, сколько бы ни длились сами шаги
+    if (replayPosition == 0) replayOrigin = scheduler->elapsed();
+    qint64 offset = qRound64(events[replayPosition].timeMs / replaySpeed);
+    scheduler->scheduleAt(GameScheduler::ReplayStep, replayOrigin + offset);
 }
 
-void MemoryGameWindow::flipBackTimeout() {
-    // Переворачиваем выбранные карты обратно рубашкой вверх
-    for (QPushButton* b : selectedButtons) {
-        b->setIcon(QIcon());
-        b->setEnabled(true);
+void MemoryGameWindow::replayTimeout() {
+    const ReplayEvent& event = replay.events()[replayPosition++];
+    if (event.action == ReplayAction::Flip) {
+        playFlipSound();
     }
-    selectedButtons.clear();
-    flipBackTimer->stop();
-    enableAllButtons(true); // Разблокируем поле
-}
-
-void MemoryGameWindow::enableAllButtons(bool enable) {
-    for (int i = 0; i < rows; ++i) {
-        for (int j = 0; j < cols; ++j) {
-            QPushButton* btn = buttons[i][j];
-            // Не включаем кнопки, которые уже найдены и отключены
-            if (!btn->isEnabled() && !enable) continue;
-
-            bool isSelected = false;
-            // Проверяем, не является ли кнопка одной из сейчас открытых
-            for (QPushButton* selBtn : selectedButtons) {
-                if (btn == selBtn) {
-                    isSelected = true;
-                    break;
-                }
-            }
-            if (!isSelected) btn->setEnabled(enable);
+    ReplayLog::apply(engine, event);
+
+    if (engine.phase() != GamePhase::Won && engine.phase() != GamePhase::Lost) {
+        scheduleReplayEvent();
+    }
+}
+
+void MemoryGameWindow::saveReplay() {
+    if (replaying || replayLog.isEmpty()) return;
+
+    // В GUI-потоке только сериализация в память, диск - в потоке записи.
+    // Имя: время окончания и зерно партии, чтобы две записи в одну
+    // миллисекунду не затирали друг друга
+    const QString dirPath = SettingsStore::dataDir() + "/replays";
+    const QString name = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz")
+                         + QString("-%1.mmrp").arg(qulonglong(replayLog.seed()), 16, 16, QChar('0'));
+    std::vector<std::uint8_t> data = replayLog.serialize();
+    replayLog.clear();
+
+    const int keep = MAX_REPLAYS;
+
+    replayWriter().start([dirPath, name, keep, data = std::move(data)]() {
+        QDir dir(dirPath);
+        if (!dir.mkpath(".")) {
+            qWarning() << "Не удалось создать папку для записей партий" << dir.path();
+            return;
+        }
+
+        QFile file(dir.filePath(name));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::NewOnly)
+            || file.write(reinterpret_cast<const char*>(data.data()), qint64(data.size())) != qint64(data.size())) {
+            qWarning() << "Не удалось сохранить запись партии" << file.fileName();
+            return;
         }
+        file.close();
+
+        // Храним только последние записи (имена по времени - старые идут первыми)
+        QFileInfoList files = dir.entryInfoList({"*.mmrp"}, QDir::Files, QDir::Name);
+        for (int i = 0; i + keep < files.size(); ++i) {
+            QFile::remove(files[i].filePath());
+        }
+    });
+}
+
+void MemoryGameWindow::recordHistory(bool won) {
+    GameRecord record;
+    record.finishedAt = QDateTime::currentMSecsSinceEpoch();
+    record.seed = engine.seed();
+    record.timeMs = quint32(qMax<qint64>(0, scheduler->elapsed() - countdownStart));
+    record.styleId = quint16(currentStyleId);
+    record.moves = quint16(engine.attempts());
+    record.rows = quint8(rows);
+    record.cols = quint8(cols);
+    record.mistakes = quint8(engine.mistakes());
+    record.matchedPairs = quint8(engine.matchedPairs());
+    if (won) {
+        record.outcome = GameOutcome::Won;
+    } else {
+        record.outcome = engine.timeLeft() <= 0 ? GameOutcome::TimeOut : GameOutcome::TooManyMistakes;
     }
+    GameHistory::instance().append(record);
+}
+
+void MemoryGameWindow::reportLatency(const QString& result) {
+    // Сессия подписывается сложностью, стилем и исходом партии: жалобы обычно
+    // на конкретное сочетание (например, Hard со стилем 4)
+    LatencyProbe& probe = LatencyProbe::instance();
+    // Окно сейчас закроется, и карты последнего клика поле уже не нарисует.
+    // Рисуем их сразу, чтобы этот клик попал в замер отрисовки
+    if (probe.isEnabled()) board->repaint();
+    probe.endSession(QString("%1/style%2/%3")
+                         .arg(currentDifficulty->getName())
+                         .arg(currentStyleId)
+                         .arg(result));
+}
+
+void MemoryGameWindow::syncBoard() {
+    CardMask faceUp = engine.faceUpCards();
+    // Показ начинается, только когда картинки стиля готовы,
+    // до этого карты лежат рубашкой вверх
+    if (engine.phase() == GamePhase::Preview && !previewShown) {
+        faceUp = 0;
+    }
+
+    // Поле перерисует только карты, у которых изменились биты.
+    // Активны только карты, которые движок разрешает открыть: найденные,
+    // открытые и всё поле на время паузы или показа заблокированы
+    board->setFaceUpCards(faceUp);
+    board->setMatchedCards(engine.matchedCards());
+    board->setEnabledCards(replaying ? 0 : engine.flippableCards());
+}
+
+// --- События движка ---
+
+void MemoryGameWindow::cardRevealed(int index) {
+    Q_UNUSED(index);
+    syncBoard();
+}
+
+void MemoryGameWindow::cardHidden(int index) {
+    Q_UNUSED(index);
+    syncBoard();
+}
+
+void MemoryGameWindow::pairMatched(int first, int second) {
+    Q_UNUSED(first);
+    Q_UNUSED(second);
+    // Совпавшие подсвечиваются зеленым и больше не активны
+    syncBoard();
+}
+
+void MemoryGameWindow::attemptMade(int attempts) {
+    attemptsLabel->setText(QString("Попытки: %1").arg(attempts));
+}
+
+void MemoryGameWindow::timeChanged(int secondsLeft) {
+    timerLabel->setText(QString("Осталось: %1 сек").arg(secondsLeft));
+}
+
+void MemoryGameWindow::phaseChanged(GamePhase phase) {
+    // Движок блокирует поле сам (показ, пауза на неверной паре, конец игры)
+    syncBoard();
+    // При повторе неверную пару закрывает событие из записи
+    if (phase == GamePhase::Mismatch && !replaying) {
+        scheduler->scheduleIn(GameScheduler::FlipBack, 1000); // Ждем секунду перед переворотом обратно
+    }
+}
+
+void MemoryGameWindow::victory(int attempts) {
+    Q_UNUSED(attempts);
+    showVictoryScreen();
+}
+
+void MemoryGameWindow::defeat(LossReason reason, int matchedPairs) {
+    Q_UNUSED(matchedPairs);
+    showGameOver(reason == LossReason::TimeOut ? "Время вышло!" : "Слишком много ошибок!");
 }
 
 void MemoryGameWindow::showVictoryScreen() {
-    gameTimer->stop();
-    enableAllButtons(false);
+    scheduler->cancel(GameScheduler::CountdownTick);
     gameBGMPlayer->stop();
     victoryPlayer->setPosition(0);
     victoryPlayer->play();
-    emit gameWon(attempts, coinMultiplier);
+    // Повтор не приносит монет и не закрывает окно
+    if (replaying) {
+        newGameButton->setEnabled(true);
+        return;
+    }
+    saveReplay();
+    recordHistory(true);
+    reportLatency("won");
+    emit gameWon(engine.attempts(), coinMultiplier);
     this->close();
 }
 
 void MemoryGameWindow::showGameOver(const QString& reason) {
     Q_UNUSED(reason); // Макрос чтобы компилятор не ругался на неиспользуемую переменную
-    gameTimer->stop();
-    enableAllButtons(false);
+    scheduler->cancel(GameScheduler::CountdownTick);
     gameBGMPlayer->stop();
     defeatPlayer->setPosition(0);
     defeatPlayer->play();
-    emit gameLost(matchedPairs, coinMultiplier);
+    if (replaying) {
+        newGameButton->setEnabled(true);
+        return;
+    }
+    saveReplay();
+    recordHistory(false);
+    reportLatency("lost");
+    emit gameLost(engine.matchedPairs(), coinMultiplier);
     this->close();
 }
 
@@ -4,29 +4,39 @@
 #include <QMainWindow>
 #include <QPushButton>
 #include <QLabel>
-#include <QGridLayout>
 #include <QTimer>
 #include <QTime>
 #include <QPixmap>
-#include <vector>
-#include <string>
-#include <map>
 
 #include <QMediaPlayer>
 #include <QAudioOutput>
 
 // Подключаем определение сложностей
 #include "difficulties.h"
+#include "gameengine.h"
+#include "replaylog.h"
+#include "gamescheduler.h"
 
-// Основной класс окна самой игры
-class MemoryGameWindow : public QMainWindow
+class BoardWidget;
+
+// Основной класс окна самой игры.
+// Правила игры - в GameEngine, окно показывает его состояние на поле,
+// отсчитывает время таймерами и проигрывает звуки
+class MemoryGameWindow : public QMainWindow, private GameEngineListener
 {
     Q_OBJECT
+    // Замеры производительности вызывают внутренние методы напрямую (tools/benchmark.cpp)
+    friend class MemoryBenchmark;
 
 public:
     explicit MemoryGameWindow(GameDifficulty* difficulty, QWidget *parent = nullptr);
     ~MemoryGameWindow();
 
+    // Показывает записанную партию со скоростью speed (2.0 - вдвое быстрее).
+    // Клики игрока на это время отключены, монеты не начисляются.
+    // false - запись для поля другого размера
+    bool playReplay(const ReplayLog& log, double speed = 1.0);
+
 signals:
     // Сигналы для сообщения главному меню о результате
     void gameWon(int moves, double coinMultiplier);
@@ -34,78 +44,112 @@ signals:
 
 private slots:
     // Обработка клика по карточке
-    void handleButtonClick();
+    void onCardClicked(int index);
     void startNewGameClicked();
-    // Срабатывает каждую секунду
-    void gameTimerTimeout();
-    // Срабатывает, когда нужно скрыть карты после предпросмотра
-    void hideAllCardsTimeout();
-    // Срабатывает, когда нужно перевернуть карты обратно (если не совпали)
-    void flipBackTimeout();
+    // Наступил срок одного из таймеров партии
+    void onScheduled(GameScheduler::Task task, qint64 deadline);
+    // Картинки стиля декодированы в фоне и готовы к показу
+    void onStyleImagesReady(int styleId, qreal devicePixelRatio);
+    // Картинки стиля загрузить не удалось
+    void onStyleImagesFailed(int styleId, qreal devicePixelRatio);
+
+protected:
+    // Ловим переезд окна на экран с другой плотностью пикселей
+    bool event(QEvent* event) override;
 
 private:
     void applyAudioSettings();
+    // Звук переворота карты
+    void playFlipSound();
     void setupUI();
-    void createGrid(); // Создание сетки кнопок
-    void fillImagePaths(); // Заполнение массива путями к картинкам
     void showAllImagesTemporarily(); // Показ всех карт в начале
+    void startPreview();             // Сам показ, когда картинки готовы (или их не будет)
     void startCountdown();
-    void showImage(QPushButton* button, const std::string& path);
+    // Очередная секунда игрового времени
+    void gameTimerTimeout();
+    // Пора скрыть карты после предпросмотра
+    void hideAllCardsTimeout();
+    // Пора перевернуть карты обратно (если не совпали)
+    void flipBackTimeout();
+    // Пора выполнить следующее действие записанной партии
+    void replayTimeout();
+    // Подгружает картинки под devicePixelRatio нового экрана
+    void updateDevicePixelRatio();
     void showGameOver(const QString& reason);
     void showVictoryScreen();
-    // Блокировка/разблокировка всех кнопок
-    void enableAllButtons(bool enable);
+    // Переносит состояние карт из движка на поле
+    void syncBoard();
+
+    // --- События движка (GameEngineListener) ---
+    void cardRevealed(int index) override;
+    void cardHidden(int index) override;
+    void pairMatched(int first, int second) override;
+    void attemptMade(int attempts) override;
+    void timeChanged(int secondsLeft) override;
+    void phaseChanged(GamePhase phase) override;
+    void victory(int attempts) override;
+    void defeat(LossReason reason, int matchedPairs) override;
 
     QString getButtonStyle();
 
     void startNewGame();
+    // Сбрасывает поле и раскладывает карты по зерну
+    void resetBoard(quint64 seed);
+
+    // Выполняет действие на движке и добавляет его в запись партии
+    void perform(ReplayAction action, int index = 0);
+    void scheduleReplayEvent();
+    // Сохраняет запись партии в папку replays рядом с exe (запись на диск - в фоне)
+    void saveReplay();
+    // Добавляет законченную партию в историю игрока (GameHistory)
+    void recordHistory(bool won);
+    // Дописывает замер задержки кликов за партию (если включен, см. LatencyProbe)
+    void reportLatency(const QString& result);
 
     // --- Параметры Игры ---
     int rows; // Строки
     int cols; // Колонки
-    int totalPairs; // Всего пар для поиска
     int memoryTime; // Время на запоминание в начале
     int gameTotalTime; // Общее время на игру
     double coinMultiplier;
 
-    // Максимальное число ошибок перед проигрышем
-    const int MAX_MISTAKES = 10;
+    // Сколько последних записей партий хранить
+    const int MAX_REPLAYS = 20;
 
     // --- Игровое Состояние ---
-    int attempts = 0; // Количество попыток
-    int matchedPairs = 0; // Найдено пар
-    int mistakes = 0; // Сделано ошибок
-    int timeLeft = 0;
-    bool gameStarted = false;
+    GameRules gameRules; // Правила по выбранной сложности
+    GameEngine engine; // Поле, счетчики и правила партии
+    bool previewShown = false; // Карты открыты для запоминания (картинки готовы)
+    bool waitingForImages = false; // Показ карт ждет фонового декодирования
     int currentStyleId = 1;
+    qreal cardPixelRatio = 1.0; // devicePixelRatio, под который взяты картинки карт
 
     // --- Элементы интерфейса ---
     QLabel* attemptsLabel;
     QLabel* timerLabel;
     QPushButton* newGameButton;
-    QGridLayout* mainGridLayout;
+    BoardWidget* board; // Само поле (все карты рисуются одним виджетом)
     QWidget* centralWidget;
 
-    // Двумерный массив кнопок (само поле)
-    std::vector<std::vector<QPushButton*>> buttons;
-    // Двумерный массив путей к картинкам (что скрыто под кнопкой)
-    std::vector<std::vector<std::string>> imagePaths;
-    // Список нажатых кнопок (сейчас может быть 0, 1 или 2)
-    std::vector<QPushButton*> selectedButtons;
-
-    // Кэш загруженных картинок, чтобы не грузить их с диска каждый раз
-    std::map<std::string, QPixmap> loadedImages;
-
     // --- Таймеры ---
-    QTimer* gameTimer;
-    QTimer* tempShowTimer;
-    QTimer* flipBackTimer;
+    // Показ карт, секунды игры, пауза на неверной паре и шаги повтора -
+    // сроки на общих часах партии (от них же время в записи партии)
+    GameScheduler* scheduler;
+
+    // --- Запись и повтор партии ---
+    ReplayLog replayLog;       // Действия текущей партии
+    bool replaying = false;    // Окно показывает записанную партию
+    ReplayLog replay;          // Показываемая запись
+    size_t replayPosition = 0; // Следующее событие записи
+    qint64 replayOrigin = 0;   // Момент на часах партии, с которого идет повтор
+    qint64 countdownStart = 0; // Момент на часах партии, когда кончился показ (для истории)
+    double replaySpeed = 1.0;
 
     // --- Аудио ---
     QMediaPlayer *gameBGMPlayer;
     QAudioOutput *gameAudioOutput;
 
-    QMediaPlayer *flipPlayer;
+    QMediaPlayer *flipPlayer; // если SoundEffects недоступен
     QAudioOutput *flipAudioOutput;
 
     QMediaPlayer *victoryPlayer;
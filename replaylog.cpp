@@ -0,0 +1,177 @@
+#include "replaylog.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const char MAGIC[4] = {'M', 'M', 'R', 'P'};
+const std::uint8_t VERSION = 1;
+
+// Фиксированная часть: магия, версия, rows, cols, maxMistakes, gameTime, seed, число событий
+const std::size_t HEADER_SIZE = 4 + 1 + 3 + 2 + 8 + 4;
+
+void putLE(std::uint8_t* data, std::uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) {
+        data[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint64_t getLE(const std::uint8_t* data, int bytes)
+{
+    std::uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= std::uint64_t(data[i]) << (8 * i);
+    }
+    return value;
+}
+
+void putVarint(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+bool getVarint(const std::uint8_t*& pos, const std::uint8_t* end, std::uint32_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35 && pos < end; shift += 7) {
+        std::uint8_t byte = *pos++;
+        value |= std::uint32_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void ReplayLog::start(const GameRules& rules, std::uint64_t seed) {
+    gameRules = rules;
+    gameSeed = seed;
+    eventList.clear();
+}
+
+void ReplayLog::add(std::uint32_t timeMs, ReplayAction action, int index) {
+    ReplayEvent event;
+    event.timeMs = timeMs;
+    event.action = action;
+    event.index = static_cast<std::uint8_t>(index);
+    eventList.push_back(event);
+}
+
+std::vector<std::uint8_t> ReplayLog::serialize() const {
+    std::vector<std::uint8_t> out;
+    // В среднем событие занимает 2-3 байта
+    out.reserve(HEADER_SIZE + eventList.size() * 3);
+
+    // Заголовок пишется по смещениям в буфер известного размера
+    out.resize(HEADER_SIZE);
+    std::uint8_t* header = out.data();
+    std::copy(MAGIC, MAGIC + 4, header);
+    header[4] = VERSION;
+    header[5] = static_cast<std::uint8_t>(gameRules.rows);
+    header[6] = static_cast<std::uint8_t>(gameRules.cols);
+    header[7] = static_cast<std::uint8_t>(gameRules.maxMistakes);
+    putLE(header + 8, static_cast<std::uint16_t>(gameRules.gameTime), 2);
+    putLE(header + 10, gameSeed, 8);
+    putLE(header + 18, eventList.size(), 4);
+
+    std::uint32_t previous = 0;
+    for (const ReplayEvent& event : eventList) {
+        out.push_back(static_cast<std::uint8_t>(static_cast<int>(event.action) << 6 | (event.index & 0x3F)));
+        // Время пишется приращением: события идут по порядку
+        putVarint(out, event.timeMs - previous);
+        previous = event.timeMs;
+    }
+    return out;
+}
+
+bool ReplayLog::deserialize(const std::uint8_t* data, std::size_t size) {
+    if (size < HEADER_SIZE || !std::equal(MAGIC, MAGIC + 4, data) || data[4] != VERSION) {
+        return false;
+    }
+
+    GameRules rules;
+    rules.rows = data[5];
+    rules.cols = data[6];
+    rules.maxMistakes = data[7];
+    rules.gameTime = static_cast<int>(getLE(data + 8, 2));
+    std::uint64_t seed = getLE(data + 10, 8);
+    std::uint32_t count = static_cast<std::uint32_t>(getLE(data + 18, 4));
+
+    int cardCount = rules.rows * rules.cols;
+    if (cardCount <= 0 || cardCount % 2 != 0 || cardCount > GameEngine::MAX_CARDS) {
+        return false;
+    }
+
+    const std::uint8_t* pos = data + HEADER_SIZE;
+    const std::uint8_t* end = data + size;
+
+    std::vector<ReplayEvent> events;
+    // Каждое событие занимает минимум 2 байта - не доверяем счетчику больше, чем данным
+    events.reserve(std::min<std::size_t>(count, size / 2));
+
+    std::uint32_t time = 0;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        if (pos >= end) return false;
+        std::uint8_t head = *pos++;
+        std::uint32_t delta = 0;
+        if (!getVarint(pos, end, delta)) return false;
+        time += delta;
+
+        ReplayEvent event;
+        event.timeMs = time;
+        event.action = static_cast<ReplayAction>(head >> 6);
+        event.index = head & 0x3F;
+        if (event.index >= cardCount) return false;
+        events.push_back(event);
+    }
+
+    gameRules = rules;
+    gameSeed = seed;
+    eventList.swap(events);
+    return true;
+}
+
+bool ReplayLog::save(const std::string& path) const {
+    std::vector<std::uint8_t> data = serialize();
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+bool ReplayLog::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return deserialize(data.data(), data.size());
+}
+
+bool ReplayLog::apply(GameEngine& engine, const ReplayEvent& event) {
+    switch (event.action) {
+    case ReplayAction::FinishPreview:
+        engine.finishPreview();
+        return true;
+    case ReplayAction::Flip:
+        return engine.flip(event.index);
+    case ReplayAction::FlipBack:
+        engine.flipBack();
+        return true;
+    case ReplayAction::Tick:
+        engine.tick();
+        return true;
+    }
+    return false;
+}
+
+void ReplayLog::replay(GameEngine& engine) const {
+    engine.newGame(gameSeed);
+    for (const ReplayEvent& event : eventList) {
+        apply(engine, event);
+    }
+}
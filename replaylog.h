@@ -0,0 +1,67 @@
+#ifndef REPLAYLOG_H
+#define REPLAYLOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gameengine.h"
+
+// Действие владельца движка - всё, что влияет на ход партии
+enum class ReplayAction : std::uint8_t {
+    FinishPreview = 0, // конец показа карт
+    Flip = 1,          // игрок открыл карту index
+    FlipBack = 2,      // неверная пара закрыта
+    Tick = 3           // прошла секунда игрового времени
+};
+
+struct ReplayEvent {
+    std::uint32_t timeMs = 0; // от начала партии
+    ReplayAction action = ReplayAction::Tick;
+    std::uint8_t index = 0;   // карта (только для Flip)
+};
+
+// Запись одной партии: правила, зерно раскладки и все действия с временем.
+// По ней партию можно повторить в точности - мгновенно через движок (replay)
+// или с любой скоростью в окне игры (MemoryGameWindow::playReplay).
+//
+// Бинарный формат (числа little-endian):
+//   "MMRP", версия (1 байт), rows, cols, maxMistakes (по 1 байту),
+//   gameTime (2 байта), seed (8 байт), число событий (4 байта),
+//   события: байт (action << 6 | index) + пауза от предыдущего события
+//   в мс (varint LEB128, обычно 1-2 байта).
+// Партия целиком занимает несколько сотен байт.
+class ReplayLog
+{
+public:
+    // Начинает новую запись (прежние события удаляются)
+    void start(const GameRules& rules, std::uint64_t seed);
+    void add(std::uint32_t timeMs, ReplayAction action, int index = 0);
+    void clear() { eventList.clear(); }
+
+    const GameRules& rules() const { return gameRules; }
+    std::uint64_t seed() const { return gameSeed; }
+    const std::vector<ReplayEvent>& events() const { return eventList; }
+    bool isEmpty() const { return eventList.empty(); }
+
+    std::vector<std::uint8_t> serialize() const;
+    // false - данные повреждены или другой версии (запись не меняется)
+    bool deserialize(const std::uint8_t* data, std::size_t size);
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Выполняет действие события на движке (так же, как это сделало окно)
+    static bool apply(GameEngine& engine, const ReplayEvent& event);
+
+    // Повторяет всю партию на движке без пауз.
+    // Движок должен быть создан с правилами записи: GameEngine(log.rules())
+    void replay(GameEngine& engine) const;
+
+private:
+    GameRules gameRules;
+    std::uint64_t gameSeed = 0;
+    std::vector<ReplayEvent> eventList;
+};
+
+#endif // REPLAYLOG_H
@@ -0,0 +1,35 @@
+#include "resourcealiases.h"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+// Таблица читается один раз при первом обращении (потокобезопасно)
+static const QHash<QString, QString>& aliasTable()
+{
+    static const QHash<QString, QString> table = []() {
+        QHash<QString, QString> result;
+        QFile file(":/aliases.json");
+        if (file.open(QIODevice::ReadOnly)) {
+            QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+            for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+                result.insert(it.key(), it.value().toString());
+            }
+        }
+        return result;
+    }();
+    return table;
+}
+
+QString ResourceAliases::resolve(const QString& path)
+{
+    return aliasTable().value(path, path);
+}
+
+QUrl ResourceAliases::url(const QString& qrcUrl)
+{
+    // "qrc:/audios/x.mp3" -> ":/audios/x.mp3" -> таблица -> обратно в "qrc:"
+    if (!qrcUrl.startsWith("qrc:")) return QUrl(qrcUrl);
+    return QUrl("qrc" + resolve(qrcUrl.mid(3)));
+}
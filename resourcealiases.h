@@ -0,0 +1,22 @@
+#ifndef RESOURCEALIASES_H
+#define RESOURCEALIASES_H
+
+#include <QString>
+#include <QUrl>
+
+// Таблица псевдонимов ресурсов.
+// Memory_assettool хранит одинаковые по содержимому файлы один раз, а для
+// повторов пишет в ":/aliases.json" ссылку на единственную копию.
+// Все пути к ресурсам нужно пропускать через resolve(), тогда старые
+// пути вида ":/audios/card_flip.mp3" продолжают работать.
+namespace ResourceAliases {
+
+// ":/путь" -> ":/путь к копии" (или тот же путь, если псевдонима нет)
+QString resolve(const QString& path);
+
+// То же для QUrl вида "qrc:/audios/x.mp3" (для QMediaPlayer)
+QUrl url(const QString& qrcUrl);
+
+}
+
+#endif // RESOURCEALIASES_H
@@ -0,0 +1,23 @@
+#ifndef REWARDS_H
+#define REWARDS_H
+
+#include <algorithm>
+
+// Награды за партию (монеты). Одни и те же формулы у главного меню
+// и у симуляции (Memory_sim), чтобы подбирать экономику по настоящим правилам
+
+// Победа: чем меньше ходов, тем больше монет (но не меньше 500)
+inline int winReward(int moves, double multiplier)
+{
+    int baseReward = std::max(500, 1000 - moves * 10);
+    return static_cast<int>(baseReward * multiplier);
+}
+
+// Поражение: 50 монет за каждую найденную пару
+inline int lossReward(int pairsFound, double multiplier)
+{
+    int baseReward = pairsFound * 50;
+    return static_cast<int>(baseReward * multiplier);
+}
+
+#endif // REWARDS_H
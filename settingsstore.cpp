@@ -0,0 +1,92 @@
+#include "settingsstore.h"
+#include <QCoreApplication>
+#include <QSettings>
+#include <QTimer>
+#include <QDebug>
+
+QString SettingsStore::customDataDir;
+
+QString SettingsStore::dataDir() {
+    return customDataDir.isEmpty() ? QCoreApplication::applicationDirPath() : customDataDir;
+}
+
+void SettingsStore::setDataDir(const QString& dir) {
+    customDataDir = dir;
+}
+
+SettingsStore& SettingsStore::instance() {
+    static SettingsStore store;
+    return store;
+}
+
+SettingsStore::SettingsStore()
+    : path(dataDir() + "/save.ini")
+    , writeTimer(new QTimer(this))
+{
+    // Единственное чтение файла за время работы программы
+    QSettings settings(path, QSettings::IniFormat);
+    const QStringList keys = settings.allKeys();
+    for (const QString& key : keys) {
+        values.insert(key, settings.value(key));
+    }
+
+    writer.setMaxThreadCount(1);
+
+    writeTimer->setSingleShot(true);
+    writeTimer->setInterval(WRITE_DELAY_MS);
+    connect(writeTimer, &QTimer::timeout, this, &SettingsStore::writeBehind);
+
+    // Несохраненные изменения дописываются при выходе
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &SettingsStore::flush);
+    }
+}
+
+SettingsStore::~SettingsStore() {
+    writer.waitForDone();
+}
+
+QVariant SettingsStore::value(const QString& key, const QVariant& defaultValue) const {
+    return values.value(key, defaultValue);
+}
+
+void SettingsStore::setValue(const QString& key, const QVariant& value) {
+    auto it = values.find(key);
+    if (it != values.end() && it.value() == value) return;
+    values.insert(key, value);
+
+    dirty = true;
+    // Таймер не перезапускается: при частых изменениях запись все равно
+    // случится не позже чем через WRITE_DELAY_MS после первого
+    if (!writeTimer->isActive()) writeTimer->start();
+}
+
+void SettingsStore::flush() {
+    writeTimer->stop();
+    writeBehind();
+    writer.waitForDone();
+}
+
+void SettingsStore::writeBehind() {
+    if (!dirty) return;
+    dirty = false;
+
+    // Потоку записи отдается снимок (QMap копируется без копирования данных)
+    const QMap<QString, QVariant> snapshot = values;
+    const QString target = path;
+    writer.start([snapshot, target]() {
+        // Файл пишет сам QSettings (экранирование, списки, @Variant - как раньше).
+        // clear() убирает ключи старого файла, которых нет в снимке. sync() пишет
+        // файл один раз и атомарно (QSettings сохраняет через QSaveFile): сбой
+        // посреди записи оставляет прежнее сохранение, временных файлов рядом нет
+        QSettings settings(target, QSettings::IniFormat);
+        settings.clear();
+        for (auto it = snapshot.constBegin(); it != snapshot.constEnd(); ++it) {
+            settings.setValue(it.key(), it.value());
+        }
+        settings.sync();
+        if (settings.status() != QSettings::NoError) {
+            qWarning() << "Не удалось сохранить настройки в" << target;
+        }
+    });
+}
@@ -0,0 +1,60 @@
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include <QObject>
+#include <QMap>
+#include <QVariant>
+#include <QThreadPool>
+
+class QTimer;
+
+// Все сохранения игры (save.ini рядом с exe) в памяти одного объекта.
+// Файл читается один раз при первом обращении, дальше чтение идет из памяти.
+// Запись откладывается: изменения за короткое время (WRITE_DELAY_MS) собираются
+// и пишутся одним разом в фоновом потоке. Пишет файл сам QSettings (IniFormat),
+// так что он остается тем же save.ini, что писала игра раньше. QSettings
+// подменяет файл целиком (QSaveFile), и сбой посреди записи не портит сохранение.
+class SettingsStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SettingsStore& instance();
+
+    QVariant value(const QString& key, const QVariant& defaultValue = QVariant()) const;
+    void setValue(const QString& key, const QVariant& value);
+    bool contains(const QString& key) const { return values.contains(key); }
+
+    // Записывает отложенные изменения сейчас и ждет окончания записи
+    // (вызывается при выходе из программы)
+    void flush();
+
+    QString filePath() const { return path; }
+
+    // Папка всех сохранений игры: save.ini, журнал монет, история, повторы партий.
+    // По умолчанию - рядом с exe. setDataDir нужно вызвать до первого обращения
+    // к хранилищам (замеры перенаправляют сохранения во временную папку)
+    static QString dataDir();
+    static void setDataDir(const QString& dir);
+
+private:
+    SettingsStore();
+    ~SettingsStore();
+    SettingsStore(const SettingsStore&) = delete;
+    SettingsStore& operator=(const SettingsStore&) = delete;
+
+    // Отдает снимок настроек фоновому потоку
+    void writeBehind();
+
+    static const int WRITE_DELAY_MS = 500;
+    static QString customDataDir;
+
+    QString path;
+    QMap<QString, QVariant> values; // ключи как в QSettings: "coins", "audio/music_enabled"
+    bool dirty = false;
+    QTimer* writeTimer;
+    // Один поток записи: снимки пишутся строго по порядку
+    QThreadPool writer;
+};
+
+#endif // SETTINGSSTORE_H
@@ -1,4 +1,5 @@
 #include "settingswindow.h"
+#include "settingsstore.h"
 
 #include <QVBoxLayout>
 #include <QCheckBox>
@@ -82,8 +83,8 @@ void SettingsWindow::setupUI()
 
 void SettingsWindow::loadSettings()
 {
-    // Создаем объект настроек. Он сам найдет файл конфигурации
-    QSettings settings(qApp->applicationDirPath() + "/save.ini", QSettings::IniFormat);
+    // Настройки уже прочитаны из save.ini при запуске
+    const SettingsStore& settings = SettingsStore::instance();
 
     // Читаем значение. Если его нет, вернем true (по умолчанию включено)
     bool musicEnabled = settings.value(MusicKey, true).toBool();
@@ -95,13 +96,12 @@ void SettingsWindow::loadSettings()
 
 void SettingsWindow::onMusicToggle(int state)
 {
-    QSettings settings(qApp->applicationDirPath() + "/save.ini", QSettings::IniFormat);
-    // Сохраняем: если галочка стоит (Qt::Checked), то true, иначе false
-    settings.setValue(MusicKey, (state == Qt::Checked));
+    // Сохраняем: если галочка стоит (Qt::Checked), то true, иначе false.
+    // Быстрые переключения туда-обратно запишутся в файл один раз
+    SettingsStore::instance().setValue(MusicKey, (state == Qt::Checked));
 }
 
 void SettingsWindow::onSoundToggle(int state)
 {
-    QSettings settings(qApp->applicationDirPath() + "/save.ini", QSettings::IniFormat);
-    settings.setValue(SoundKey, (state == Qt::Checked));
+    SettingsStore::instance().setValue(SoundKey, (state == Qt::Checked));
 }
@@ -0,0 +1,128 @@
+#include "simulation.h"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+int RandomBot::chooseCard(const GameEngine& engine, SplitMix64& rng) {
+    return randomCard(engine.flippableCards(), rng);
+}
+
+std::string MemoryBot::name() const {
+    if (forgetRate <= 0.0) return "perfect";
+    std::ostringstream label;
+    label << "forgetful:" << forgetRate;
+    return label.str();
+}
+
+void MemoryBot::startGame() {
+    known = 0;
+    knownById.fill(0);
+}
+
+void MemoryBot::observe(int index, CardId id) {
+    if (known & cardBit(index)) return;
+    known |= cardBit(index);
+    ids[index] = id;
+    knownById[id] |= cardBit(index);
+}
+
+void MemoryBot::forget(int index) {
+    known &= ~cardBit(index);
+    knownById[ids[index]] &= ~cardBit(index);
+}
+
+int MemoryBot::chooseCard(const GameEngine& engine, SplitMix64& rng) {
+    const CardMask flippable = engine.flippableCards();
+    const CardMask selected = engine.selectedCards();
+    const CardMask unknown = flippable & ~known;
+
+    if (selected == 0) {
+        // Первая карта хода: если помним обе карты какой-то пары - берем ее
+        for (int id = 1; id <= engine.pairCount(); ++id) {
+            CardMask pair = knownById[id] & flippable;
+            if (cardsIn(pair) == 2) return lowestCard(pair);
+        }
+    } else {
+        // Вторая карта: вторая половина открытой карты, если ее помним
+        CardMask twin = knownById[engine.cardAt(lowestCard(selected))] & flippable;
+        if (twin) return lowestCard(twin);
+    }
+
+    // Иначе открываем карту, которую еще не видели (или любую, если видели все)
+    return randomCard(unknown ? unknown : flippable, rng);
+}
+
+void MemoryBot::turnEnded(SplitMix64& rng) {
+    if (forgetRate <= 0.0) return;
+    for (CardMask mask = known; mask; mask &= mask - 1) {
+        if (uniform01(rng) < forgetRate) forget(lowestCard(mask));
+    }
+}
+
+std::unique_ptr<Bot> createBot(const std::string& spec) {
+    if (spec == "random") return std::make_unique<RandomBot>();
+    if (spec == "perfect") return std::make_unique<MemoryBot>(0.0);
+    if (spec.rfind("forgetful", 0) == 0) {
+        double rate = 0.05;
+        if (spec.size() > 10 && spec[9] == ':') {
+            rate = std::atof(spec.c_str() + 10);
+        } else if (spec.size() != 9) {
+            return nullptr;
+        }
+        return std::make_unique<MemoryBot>(std::clamp(rate, 0.0, 1.0));
+    }
+    return nullptr;
+}
+
+SimResult simulateGame(GameEngine& engine, Bot& bot, SplitMix64& rng, const SimTiming& timing) {
+    engine.newGame(rng.next());
+    bot.startGame();
+
+    // За время показа бот запоминает несколько случайных карт
+    const int count = engine.cardCount();
+    int previewCards = std::min(count, static_cast<int>(timing.memoryTime * timing.previewCardsPerSecond));
+    CardMask unseen = engine.allCards();
+    for (int i = 0; i < previewCards; ++i) {
+        int index = randomCard(unseen, rng);
+        unseen &= ~cardBit(index);
+        bot.observe(index, engine.cardAt(index));
+    }
+    engine.finishPreview();
+
+    // Игровое время: движок получает тик на каждой целой секунде
+    double clock = 0;
+    int ticks = 0;
+    auto advance = [&](double seconds) {
+        clock += seconds;
+        while (ticks + 1 <= clock
+               && (engine.phase() == GamePhase::Playing || engine.phase() == GamePhase::Mismatch)) {
+            engine.tick();
+            ticks++;
+        }
+    };
+
+    while (engine.phase() == GamePhase::Playing) {
+        int index = bot.chooseCard(engine, rng);
+        advance(timing.flipSeconds);
+        if (engine.phase() != GamePhase::Playing) break; // время вышло, пока думал
+
+        engine.flip(index);
+        bot.observe(index, engine.cardAt(index));
+
+        if (engine.phase() == GamePhase::Mismatch) {
+            advance(timing.flipBackSeconds);
+            if (engine.phase() == GamePhase::Mismatch) engine.flipBack();
+            bot.turnEnded(rng);
+        } else if (engine.selectedCards() == 0) {
+            bot.turnEnded(rng);
+        }
+    }
+
+    SimResult result;
+    result.won = engine.phase() == GamePhase::Won;
+    result.attempts = engine.attempts();
+    result.mistakes = engine.mistakes();
+    result.matchedPairs = engine.matchedPairs();
+    result.seconds = timing.memoryTime + clock;
+    return result;
+}
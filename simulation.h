@@ -0,0 +1,113 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include "gameengine.h"
+
+// Игрок-бот для симуляции партий без окна (Memory_sim, решатель).
+// Бот видит только то, что видел бы человек: открытые карты (observe)
+// и наборы карт движка (какие можно открыть, какие открыты в этом ходу).
+class Bot
+{
+public:
+    virtual ~Bot() = default;
+
+    virtual std::string name() const = 0;
+
+    // Новая партия: бот забывает прошлую раскладку
+    virtual void startGame() {}
+    // Бот увидел картинку карты (при показе в начале или при открытии)
+    virtual void observe(int index, CardId id) { (void)index; (void)id; }
+    // Какую карту открыть (из engine.flippableCards())
+    virtual int chooseCard(const GameEngine& engine, SplitMix64& rng) = 0;
+    // Ход (две карты) закончен
+    virtual void turnEnded(SplitMix64& rng) { (void)rng; }
+};
+
+// Открывает случайную карту, ничего не запоминает
+class RandomBot : public Bot
+{
+public:
+    std::string name() const override { return "random"; }
+    int chooseCard(const GameEngine& engine, SplitMix64& rng) override;
+};
+
+// Запоминает увиденные карты и забирает известные пары.
+// forgetRate - вероятность забыть каждую запомненную карту после каждого хода
+// (0 - идеальная память)
+class MemoryBot : public Bot
+{
+public:
+    explicit MemoryBot(double forgetRate = 0.0) : forgetRate(forgetRate) {}
+
+    std::string name() const override;
+    void startGame() override;
+    void observe(int index, CardId id) override;
+    int chooseCard(const GameEngine& engine, SplitMix64& rng) override;
+    void turnEnded(SplitMix64& rng) override;
+
+private:
+    void forget(int index);
+
+    double forgetRate;
+    CardMask known = 0;                                     // карты, которые бот помнит
+    std::array<CardId, GameEngine::MAX_CARDS> ids{};        // что на них
+    std::array<CardMask, GameEngine::MAX_CARDS / 2 + 1> knownById{}; // запомненные карты по картинке
+};
+
+// Бот по имени: "random", "perfect", "forgetful" или "forgetful:0.2"
+// (вероятность забыть карту за ход, по умолчанию 0.05). nullptr - неизвестное имя
+std::unique_ptr<Bot> createBot(const std::string& spec);
+
+// Темп игры бота. Время в партии идет так же, как в окне:
+// тик движка раз в секунду, пауза на неверной паре
+struct SimTiming {
+    int memoryTime = 10;               // показ карт в начале (сек)
+    double previewCardsPerSecond = 1.0; // сколько карт бот успевает запомнить за секунду показа
+    double flipSeconds = 1.0;          // время на открытие одной карты
+    double flipBackSeconds = 1.0;      // пауза на неверной паре (flipBackTimer окна)
+};
+
+struct SimResult {
+    bool won = false;
+    int attempts = 0;
+    int mistakes = 0;
+    int matchedPairs = 0;
+    double seconds = 0; // длительность партии вместе с показом
+};
+
+// Играет одну партию ботом на движке (у движка не должно быть слушателя,
+// иначе симуляция замедлится на его вызовах). Зерно раскладки берется из rng
+SimResult simulateGame(GameEngine& engine, Bot& bot, SplitMix64& rng, const SimTiming& timing);
+
+// Серия партий делится на куски по SIM_CHUNK_GAMES, у каждого куска свое зерно,
+// а потоки разбирают куски по очереди. Результат серии зависит только от зерна
+// и числа партий, но не от числа потоков (--threads и число ядер)
+const std::uint64_t SIM_CHUNK_GAMES = 4096;
+
+// Зерно куска chunk: chunk-е число последовательности SplitMix64(seed)
+inline std::uint64_t chunkSeed(std::uint64_t seed, std::uint64_t chunk)
+{
+    SplitMix64 rng(seed + chunk * 0x9E3779B97F4A7C15ull);
+    return rng.next();
+}
+
+// Случайное число от 0 до 1 (53 бита)
+inline double uniform01(SplitMix64& rng)
+{
+    return (rng.next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Случайная карта из набора (набор не пустой)
+inline int randomCard(CardMask mask, SplitMix64& rng)
+{
+    for (std::uint32_t skip = rng.below(static_cast<std::uint32_t>(cardsIn(mask))); skip > 0; --skip) {
+        mask &= mask - 1;
+    }
+    return lowestCard(mask);
+}
+
+#endif // SIMULATION_H
@@ -0,0 +1,203 @@
+#include "solver.h"
+#include "rewards.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// Добавляет распределение from, сдвинутое на shift ошибок, с весом weight
+void addShifted(std::vector<double>& to, const std::vector<double>& from, int shift, double weight)
+{
+    if (weight <= 0) return;
+    if (to.size() < from.size() + shift) to.resize(from.size() + shift, 0.0);
+    for (std::size_t m = 0; m < from.size(); ++m) {
+        to[m + shift] += weight * from[m];
+    }
+}
+
+double binomial(int n, int k)
+{
+    if (k < 0 || k > n) return 0;
+    double result = 1;
+    for (int i = 1; i <= k; ++i) result = result * (n - k + i) / i;
+    return result;
+}
+
+} // namespace
+
+double SolverResult::expectedMistakes() const {
+    double sum = 0;
+    for (std::size_t m = 0; m < mistakes.size(); ++m) sum += m * mistakes[m];
+    return sum;
+}
+
+double SolverResult::winProbability(int maxMistakes) const {
+    double sum = 0;
+    for (std::size_t m = 0; m < mistakes.size() && static_cast<int>(m) < maxMistakes; ++m) sum += mistakes[m];
+    return sum;
+}
+
+int SolverResult::mistakePercentile(double p) const {
+    double sum = 0;
+    for (std::size_t m = 0; m < mistakes.size(); ++m) {
+        sum += mistakes[m];
+        if (sum >= p) return static_cast<int>(m);
+    }
+    return static_cast<int>(mistakes.size()) - 1;
+}
+
+double SolverResult::expectedWinReward(int pairCount, int maxMistakes, double multiplier) const {
+    double sum = 0;
+    for (std::size_t m = 0; m < mistakes.size() && static_cast<int>(m) < maxMistakes; ++m) {
+        // Ходов в выигранной партии: по одному на каждую пару плюс ошибки
+        sum += mistakes[m] * winReward(pairCount + static_cast<int>(m), multiplier);
+    }
+    return sum;
+}
+
+double SolverResult::expectedRewardPerWin(int pairCount, int maxMistakes, double multiplier) const {
+    const double wins = winProbability(maxMistakes);
+    return wins > 0 ? expectedWinReward(pairCount, maxMistakes, multiplier) / wins : 0;
+}
+
+ExactSolver::ExactSolver(int cardCount)
+    : cards(cardCount)
+    , states(static_cast<std::size_t>(cardCount + 1) * (cardCount / 2 + 1))
+{
+}
+
+ExactSolver::State& ExactSolver::state(int unknown, int singles) {
+    State& s = states[static_cast<std::size_t>(unknown) * (cards / 2 + 1) + singles];
+    if (s.solved) return s;
+    s.solved = true;
+
+    if (unknown == 0) {
+        s.mistakes = { 1.0 };
+        return s;
+    }
+
+    const double u = unknown;
+    const int k = singles;
+
+    // Первая карта хода - всегда новая. С вероятностью k/u это пара
+    // к уже известной карте: забираем пару без ошибки
+    if (k > 0) {
+        const State& next = state(unknown - 1, k - 1);
+        s.attempts += k / u * (1 + next.attempts);
+        addShifted(s.mistakes, next.mistakes, 0, k / u);
+    }
+    if (unknown == k) return s;
+
+    // Иначе открыта совсем новая карта, и есть два варианта второй карты
+    const double pNew = (unknown - k) / u;
+
+    // Открыть еще одну новую (осталось u - 1):
+    // - ее пара - первая карта: совпадение;
+    // - пара к известной карте: ошибка, зато следующим ходом забираем эту пару;
+    // - снова новая: ошибка, известных одиночек становится на две больше
+    const double rest = u - 1;
+    const State& afterMatch = state(unknown - 2, k);
+    double explore = (1 / rest) * (1 + afterMatch.attempts)
+                   + (k / rest) * (2 + afterMatch.attempts);
+    const int fresh = unknown - 2 - k;
+    if (fresh > 0) explore += (fresh / rest) * (1 + state(unknown - 2, k + 2).attempts);
+
+    // Открыть известную карту: верная ошибка, но ничего нового не тратим
+    double safe = 1e300;
+    if (k > 0) safe = 1 + state(unknown - 1, k + 1).attempts;
+
+    if (safe < explore) {
+        s.safeMove = true;
+        const State& next = state(unknown - 1, k + 1);
+        s.attempts += pNew * safe;
+        addShifted(s.mistakes, next.mistakes, 1, pNew);
+    } else {
+        s.attempts += pNew * explore;
+        addShifted(s.mistakes, afterMatch.mistakes, 0, pNew / rest);
+        addShifted(s.mistakes, afterMatch.mistakes, 1, pNew * k / rest);
+        if (fresh > 0) addShifted(s.mistakes, state(unknown - 2, k + 2).mistakes, 1, pNew * fresh / rest);
+    }
+    return s;
+}
+
+double ExactSolver::expectedAttempts(int unknown, int singles) {
+    return state(unknown, singles).attempts;
+}
+
+const std::vector<double>& ExactSolver::mistakeDistribution(int unknown, int singles) {
+    return state(unknown, singles).mistakes;
+}
+
+SolverResult ExactSolver::solve(int previewCards) {
+    const int pairs = cards / 2;
+    const int seen = std::clamp(previewCards, 0, cards);
+
+    // При показе игрок запомнил seen случайных карт: из них full пар целиком
+    // (их забирает без ошибок) и seen - 2 * full одиночек
+    SolverResult result;
+    const double layouts = binomial(cards, seen);
+    for (int full = 0; 2 * full <= seen; ++full) {
+        const int singles = seen - 2 * full;
+        if (full + singles > pairs) continue;
+        const double p = binomial(pairs, full) * binomial(pairs - full, singles) * std::ldexp(1.0, singles) / layouts;
+        if (p <= 0) continue;
+
+        const State& start = state(cards - seen, singles);
+        result.expectedAttempts += p * (full + start.attempts);
+        addShifted(result.mistakes, start.mistakes, 0, p);
+    }
+    return result;
+}
+
+SolverResult monteCarloSolve(const GameRules& rules, const std::string& botSpec, const SimTiming& timing,
+                             std::uint64_t games, unsigned threads, std::uint64_t seed) {
+    SolverResult result;
+    if (!createBot(botSpec) || games == 0) return result;
+    threads = std::max(1u, threads);
+
+    GameRules unlimited = rules;
+    unlimited.maxMistakes = INT_MAX;
+    unlimited.gameTime = INT_MAX;
+
+    // Поток копит число партий по числу ошибок, в конце гистограммы складываются
+    std::vector<std::vector<std::uint64_t>> histograms(threads);
+    std::vector<std::uint64_t> attempts(threads, 0);
+    std::vector<std::thread> workers;
+    // Куски партий со своими зернами (SIM_CHUNK_GAMES): итог не зависит от числа потоков
+    const std::uint64_t chunks = (games + SIM_CHUNK_GAMES - 1) / SIM_CHUNK_GAMES;
+
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            GameEngine engine(unlimited);
+            std::unique_ptr<Bot> bot = createBot(botSpec);
+            std::vector<std::uint64_t>& histogram = histograms[t];
+            // Сумма копится локально: соседние attempts[t] лежат в одной строке кэша
+            std::uint64_t threadAttempts = 0;
+            for (std::uint64_t chunk = t; chunk < chunks; chunk += threads) {
+                SplitMix64 rng(chunkSeed(seed, chunk));
+                const std::uint64_t count = std::min(SIM_CHUNK_GAMES, games - chunk * SIM_CHUNK_GAMES);
+                for (std::uint64_t i = 0; i < count; ++i) {
+                    SimResult game = simulateGame(engine, *bot, rng, timing);
+                    if (histogram.size() <= static_cast<std::size_t>(game.mistakes)) histogram.resize(game.mistakes + 1, 0);
+                    histogram[game.mistakes]++;
+                    threadAttempts += game.attempts;
+                }
+            }
+            attempts[t] = threadAttempts;
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    std::uint64_t totalAttempts = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+        totalAttempts += attempts[t];
+        if (result.mistakes.size() < histograms[t].size()) result.mistakes.resize(histograms[t].size(), 0.0);
+        for (std::size_t m = 0; m < histograms[t].size(); ++m) {
+            result.mistakes[m] += double(histograms[t][m]) / games;
+        }
+    }
+    result.expectedAttempts = double(totalAttempts) / games;
+    return result;
+}
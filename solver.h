@@ -0,0 +1,72 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gameengine.h"
+#include "simulation.h"
+
+// Сколько ходов и ошибок нужно, чтобы открыть всё поле.
+// Время партии и предел ошибок здесь не учитываются: по распределению ошибок
+// видно, какой предел (GameDifficulty::getMaxMistakes) сколько партий оставит выигранными
+struct SolverResult {
+    double expectedAttempts = 0;
+    std::vector<double> mistakes; // mistakes[m] - вероятность закончить ровно с m ошибками
+
+    double expectedMistakes() const;
+    // Доля партий, где ошибок меньше maxMistakes (движок засчитывает поражение на maxMistakes)
+    double winProbability(int maxMistakes) const;
+    // Наименьшее m, для которого P(ошибок <= m) >= p
+    int mistakePercentile(double p) const;
+    // Средние монеты за победы (winReward) в расчете на одну партию:
+    // проигранные партии (предел ошибок) считаются как 0
+    double expectedWinReward(int pairCount, int maxMistakes, double multiplier) const;
+    // Средние монеты за одну выигранную партию (только среди побед)
+    double expectedRewardPerWin(int pairCount, int maxMistakes, double multiplier) const;
+};
+
+// Точное решение для игрока с идеальной памятью, играющего оптимально.
+// Состояние партии - (unknown, singles): сколько карт еще ни разу не открывали
+// и сколько открытых раньше карт ждут свою пару среди них. Уже известные пары
+// игрок забирает сразу, так что остальное на ожидание не влияет.
+// Из состояния ход ведет только в состояния с меньшим unknown, поэтому
+// их всего (MAX_CARDS + 1) * (MAX_CARDS / 2 + 1), и каждое считается один раз
+// (результаты запоминаются) - всё поле 8x8 решается за доли миллисекунды.
+class ExactSolver
+{
+public:
+    explicit ExactSolver(int cardCount);
+
+    int cardCount() const { return cards; }
+
+    double expectedAttempts(int unknown, int singles);
+    const std::vector<double>& mistakeDistribution(int unknown, int singles);
+
+    // Целая партия. previewCards - сколько случайных карт игрок запомнил при показе
+    SolverResult solve(int previewCards = 0);
+
+private:
+    struct State {
+        bool solved = false;
+        bool safeMove = false;      // выгоднее открыть известную карту, чем новую
+        double attempts = 0;        // ожидаемое число ходов до конца
+        std::vector<double> mistakes;
+    };
+
+    State& state(int unknown, int singles);
+
+    int cards;
+    std::vector<State> states; // [unknown * (cards / 2 + 1) + singles]
+};
+
+// Оценка методом Монте-Карло для любого бота (в том числе с забыванием):
+// games партий на threads потоках, у каждого потока свой движок и бот.
+// При одном seed результат одинаков при любом threads (см. SIM_CHUNK_GAMES).
+// Правила берутся из rules, но без предела ошибок и времени.
+// Пустой результат - неизвестный бот
+SolverResult monteCarloSolve(const GameRules& rules, const std::string& botSpec, const SimTiming& timing,
+                             std::uint64_t games, unsigned threads, std::uint64_t seed);
+
+#endif // SOLVER_H
@@ -0,0 +1,250 @@
+#include "soundeffects.h"
+#include "resourcealiases.h"
+#include <QAudioBuffer>
+#include <QAudioDecoder>
+#include <QAudioDevice>
+#include <QAudioSink>
+#include <QCoreApplication>
+#include <QMediaDevices>
+#include <QFile>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+// Декодированный звук как есть: сэмплы в -1..1, формат файла
+struct RawClip {
+    QVector<float> samples;
+    QAudioFormat format;
+};
+
+// Переводит звук в частоту и число каналов вывода (линейная интерполяция).
+// Делается один раз при загрузке, микшеру остается только складывать
+QVector<float> convertClip(const RawClip& raw, const QAudioFormat& to)
+{
+    const int srcChannels = raw.format.channelCount();
+    const int dstChannels = to.channelCount();
+    const int srcRate = raw.format.sampleRate();
+    const int dstRate = to.sampleRate();
+    if (srcChannels <= 0 || dstChannels <= 0 || srcRate <= 0 || dstRate <= 0) return {};
+
+    const qint64 srcFrames = raw.samples.size() / srcChannels;
+    const qint64 dstFrames = srcFrames * dstRate / srcRate;
+
+    // Сэмпл канала channel вывода из кадра frame файла
+    auto sample = [&](qint64 frame, int channel) -> float {
+        const float* in = raw.samples.constData() + frame * srcChannels;
+        if (dstChannels == 1 && srcChannels > 1) {
+            float sum = 0;
+            for (int c = 0; c < srcChannels; ++c) sum += in[c];
+            return sum / srcChannels;
+        }
+        // Моно звук идет во все каналы, лишние каналы файла отбрасываются
+        return in[std::min(channel, srcChannels - 1)];
+    };
+
+    QVector<float> result(dstFrames * dstChannels);
+    for (qint64 i = 0; i < dstFrames; ++i) {
+        const double position = double(i) * srcRate / dstRate;
+        const qint64 frame = qint64(position);
+        const qint64 next = std::min(frame + 1, srcFrames - 1);
+        const float t = float(position - frame);
+        for (int c = 0; c < dstChannels; ++c) {
+            result[i * dstChannels + c] = sample(frame, c) * (1 - t) + sample(next, c) * t;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+// --- Микшер ---
+
+void SoundEffects::Mixer::setClip(Effect effect, QVector<float> samples) {
+    QMutexLocker lock(&mutex);
+    clips[effect] = std::move(samples);
+}
+
+bool SoundEffects::Mixer::hasClip(Effect effect) const {
+    QMutexLocker lock(&mutex);
+    return !clips[effect].isEmpty();
+}
+
+void SoundEffects::Mixer::start(Effect effect) {
+    QMutexLocker lock(&mutex);
+    // Свободный голос, а если все заняты - самый давно запущенный
+    Voice* voice = &voices[0];
+    for (Voice& candidate : voices) {
+        if (candidate.effect < 0) {
+            voice = &candidate;
+            break;
+        }
+        if (candidate.order < voice->order) voice = &candidate;
+    }
+    voice->effect = effect;
+    voice->position = 0;
+    voice->order = ++started;
+}
+
+qint64 SoundEffects::Mixer::bytesAvailable() const {
+    // Поток не кончается: когда звуков нет, отдается тишина
+    return QIODevice::bytesAvailable() + outputFormat.bytesForDuration(BUFFER_MS * 1000);
+}
+
+qint64 SoundEffects::Mixer::readData(char* data, qint64 maxSize) {
+    const int frameBytes = outputFormat.bytesPerFrame();
+    if (frameBytes <= 0) return 0;
+    const qint64 frames = maxSize / frameBytes;
+    const int count = int(frames * outputFormat.channelCount());
+
+    {
+        QMutexLocker lock(&mutex);
+        mixBuffer.fill(0.0f, count);
+        for (Voice& voice : voices) {
+            if (voice.effect < 0) continue;
+            const QVector<float>& clip = clips[voice.effect];
+            const int length = std::min(count, int(clip.size()) - voice.position);
+            const float* in = clip.constData() + voice.position;
+            for (int i = 0; i < length; ++i) mixBuffer[i] += in[i];
+            voice.position += length;
+            if (voice.position >= clip.size()) voice.effect = -1;
+        }
+    }
+
+    // Перевод в формат устройства с ограничением: наложенные звуки могут выйти за 1
+    for (int i = 0; i < count; ++i) {
+        const float value = std::clamp(mixBuffer[i], -1.0f, 1.0f);
+        switch (outputFormat.sampleFormat()) {
+        case QAudioFormat::Float:
+            reinterpret_cast<float*>(data)[i] = value;
+            break;
+        case QAudioFormat::Int16:
+            reinterpret_cast<qint16*>(data)[i] = qint16(value * 32767);
+            break;
+        case QAudioFormat::Int32:
+            reinterpret_cast<qint32*>(data)[i] = qint32(double(value) * 2147483647.0);
+            break;
+        case QAudioFormat::UInt8:
+            reinterpret_cast<quint8*>(data)[i] = quint8(128 + value * 127);
+            break;
+        default:
+            std::memset(data, 0, size_t(frames * frameBytes));
+            return frames * frameBytes;
+        }
+    }
+    return frames * frameBytes;
+}
+
+// --- Звуковые эффекты ---
+
+SoundEffects& SoundEffects::instance() {
+    static SoundEffects effects;
+    return effects;
+}
+
+SoundEffects::SoundEffects()
+    : mixer(new Mixer(this))
+{
+}
+
+SoundEffects::~SoundEffects() {
+}
+
+void SoundEffects::preload() {
+    if (sink) return;
+
+    const QAudioDevice device = QMediaDevices::defaultAudioOutput();
+    if (device.isNull()) {
+        qWarning() << "Нет устройства вывода звука, эффекты будут играть через QMediaPlayer";
+        return;
+    }
+
+    // Формат, который устройство принимает без преобразований
+    format = device.preferredFormat();
+    mixer->setFormat(format);
+    mixer->open(QIODevice::ReadOnly);
+
+    sink = new QAudioSink(device, format, this);
+    sink->setBufferSize(format.bytesForDuration(BUFFER_MS * 1000));
+    sink->setVolume(volume);
+    sink->start(mixer);
+    if (sink->error() != QAudio::NoError) {
+        qWarning() << "Не удалось открыть вывод звука:" << sink->error();
+        delete sink;
+        sink = nullptr;
+        return;
+    }
+    // Устройство может выделить буфер другого размера, а от него зависит задержка старта звука
+    qDebug() << "Буфер вывода звука:" << format.durationForBytes(sink->bufferSize()) / 1000 << "мс";
+
+    // Вывод закрывается вместе с приложением, а не при уничтожении статических объектов
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+            delete sink;
+            sink = nullptr;
+        });
+    }
+
+    decode(CardFlip, ":/audios/card_flip.mp3");
+    decode(ButtonClick, ":/audios/button_click.mp3");
+}
+
+void SoundEffects::decode(Effect effect, const QString& path) {
+    QAudioDecoder* decoder = new QAudioDecoder(this);
+    QFile* file = new QFile(ResourceAliases::resolve(path), decoder);
+    if (!file->open(QIODevice::ReadOnly)) {
+        qWarning() << "Не удалось открыть звук" << path;
+        delete decoder;
+        return;
+    }
+    decoder->setSourceDevice(file);
+
+    auto raw = std::make_shared<RawClip>();
+
+    connect(decoder, &QAudioDecoder::bufferReady, this, [decoder, raw]() {
+        const QAudioBuffer buffer = decoder->read();
+        if (!buffer.isValid()) return;
+        raw->format = buffer.format();
+        const int sampleBytes = raw->format.bytesPerSample();
+        const char* data = buffer.constData<char>();
+        const int count = int(buffer.sampleCount());
+        raw->samples.reserve(raw->samples.size() + count);
+        for (int i = 0; i < count; ++i) {
+            raw->samples.append(raw->format.normalizedSampleValue(data + i * sampleBytes));
+        }
+    });
+
+    connect(decoder, &QAudioDecoder::finished, this, [this, decoder, raw, effect, path]() {
+        QVector<float> samples = convertClip(*raw, format);
+        if (samples.isEmpty()) {
+            qWarning() << "Звук" << path << "декодирован пустым";
+        }
+        mixer->setClip(effect, std::move(samples));
+        decoder->deleteLater();
+    });
+
+    connect(decoder, QOverload<QAudioDecoder::Error>::of(&QAudioDecoder::error), this, [decoder, path]() {
+        qWarning() << "Не удалось декодировать звук" << path << decoder->errorString();
+        decoder->deleteLater();
+    });
+
+    decoder->start();
+}
+
+bool SoundEffects::isReady(Effect effect) const {
+    return sink && sink->state() != QAudio::StoppedState && mixer->hasClip(effect);
+}
+
+bool SoundEffects::play(Effect effect) {
+    if (!isReady(effect)) return false;
+    // Выключенный звук не занимает голоса
+    if (volume > 0) mixer->start(effect);
+    return true;
+}
+
+void SoundEffects::setVolume(float value) {
+    volume = value;
+    if (sink) sink->setVolume(volume);
+}
@@ -0,0 +1,100 @@
+#ifndef SOUNDEFFECTS_H
+#define SOUNDEFFECTS_H
+
+#include <QObject>
+#include <QIODevice>
+#include <QAudioFormat>
+#include <QMutex>
+#include <QVector>
+#include <array>
+
+class QAudioSink;
+
+// Короткие звуки (переворот карты, клик по кнопке) без QMediaPlayer.
+// При запуске (preload) mp3 один раз декодируются в PCM и хранятся в памяти,
+// а играет их свой микшер: один QAudioSink в режиме pull, открытый на все
+// время работы программы, без перемотки и запуска медиаконвейера.
+// Новый звук попадает в буфер вывода при следующем заполнении и звучит после
+// уже лежащих там данных, то есть задержка старта - не больше длины буфера
+// (BUFFER_MS, фактический размер пишется в лог при запуске).
+// Звуки накладываются друг на друга (до MAX_VOICES голосов), частые клики
+// не обрывают предыдущий звук. Если голоса кончились - заменяется самый старый.
+class SoundEffects : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Effect { CardFlip, ButtonClick, EffectCount };
+
+    static SoundEffects& instance();
+
+    // Начинает декодирование звуков и открывает вывод звука.
+    // Декодирование идет в фоне, звук доступен, когда isReady() == true
+    void preload();
+
+    bool isReady(Effect effect) const;
+
+    // Запускает звук. false - звук еще не декодирован или вывода нет,
+    // тогда вызывающий код играет его по-старому, через QMediaPlayer
+    bool play(Effect effect);
+
+    // Громкость всех эффектов, 0..1 (настройка "audio/sound_enabled")
+    void setVolume(float volume);
+
+private:
+    SoundEffects();
+    ~SoundEffects();
+    SoundEffects(const SoundEffects&) = delete;
+    SoundEffects& operator=(const SoundEffects&) = delete;
+
+    // Источник данных для QAudioSink: смешивает звучащие голоса
+    class Mixer : public QIODevice
+    {
+    public:
+        explicit Mixer(QObject* parent) : QIODevice(parent) {}
+
+        void setFormat(const QAudioFormat& format) { outputFormat = format; }
+        // Звук в формате вывода: float, каналы вперемешку
+        void setClip(Effect effect, QVector<float> samples);
+        bool hasClip(Effect effect) const;
+        void start(Effect effect);
+
+        bool isSequential() const override { return true; }
+        qint64 bytesAvailable() const override;
+
+    protected:
+        qint64 readData(char* data, qint64 maxSize) override;
+        qint64 writeData(const char*, qint64) override { return -1; }
+
+    private:
+        struct Voice {
+            int effect = -1; // -1 - голос свободен
+            int position = 0; // следующий сэмпл
+            quint64 order = 0; // порядок запуска, для замены самого старого
+        };
+
+        static const int MAX_VOICES = 8;
+
+        QAudioFormat outputFormat;
+        mutable QMutex mutex; // readData может вызываться из потока звука
+        std::array<QVector<float>, EffectCount> clips;
+        std::array<Voice, MAX_VOICES> voices;
+        quint64 started = 0;
+        QVector<float> mixBuffer;
+    };
+
+    // Декодирует файл ресурсов и отдает звук микшеру
+    void decode(Effect effect, const QString& path);
+
+    // Буфер вывода. Данные в него подкладываются из цикла событий GUI-потока,
+    // поэтому он должен пережить перерисовку поля или декодирование атласа
+    // на Hard без провала звука (10 мс не хватало - были щелчки)
+    static const int BUFFER_MS = 30;
+
+    QAudioFormat format;
+    QAudioSink* sink = nullptr;
+    Mixer* mixer;
+    float volume = 0.8f;
+};
+
+#endif // SOUNDEFFECTS_H
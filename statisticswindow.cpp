@@ -0,0 +1,192 @@
+#include "statisticswindow.h"
+#include "gamehistory.h"
+#include "difficulties.h"
+
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTabWidget>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDateTime>
+#include <memory>
+
+namespace {
+
+// Секунды с десятыми: "42.7 с"
+QString formatTime(quint32 timeMs)
+{
+    return QString("%1 с").arg(timeMs / 1000.0, 0, 'f', 1);
+}
+
+QTableWidget* createTable(const QStringList& headers, int rows)
+{
+    QTableWidget* table = new QTableWidget(rows, headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionMode(QAbstractItemView::NoSelection);
+    return table;
+}
+
+void setCell(QTableWidget* table, int row, int column, const QString& text)
+{
+    QTableWidgetItem* item = new QTableWidgetItem(text);
+    item->setTextAlignment(Qt::AlignCenter);
+    table->setItem(row, column, item);
+}
+
+// Сложности игры в порядке меню
+std::vector<std::unique_ptr<GameDifficulty>> allDifficulties()
+{
+    std::vector<std::unique_ptr<GameDifficulty>> list;
+    list.emplace_back(new EasyDifficulty());
+    list.emplace_back(new MediumDifficulty());
+    list.emplace_back(new HardDifficulty());
+    return list;
+}
+
+} // namespace
+
+StatisticsWindow::StatisticsWindow(QWidget *parent)
+    : QDialog(parent)
+{
+    setupUI();
+    applyStyles();
+}
+
+StatisticsWindow::~StatisticsWindow()
+{
+}
+
+void StatisticsWindow::setupUI()
+{
+    setWindowTitle("Статистика");
+    setFixedSize(600, 560);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setSpacing(15);
+    layout->setContentsMargins(20, 20, 20, 20);
+
+    const HistoryStats& overall = GameHistory::instance().overall();
+
+    QLabel *title = new QLabel("Статистика");
+    title->setObjectName("titleLabel");
+    title->setAlignment(Qt::AlignCenter);
+    layout->addWidget(title);
+
+    QLabel *streakLabel = new QLabel(QString("Побед подряд: %1 (лучшая серия: %2)")
+                                         .arg(overall.currentStreak).arg(overall.bestStreak));
+    streakLabel->setAlignment(Qt::AlignCenter);
+    layout->addWidget(streakLabel);
+
+    QTabWidget *tabs = new QTabWidget();
+    tabs->addTab(createSummaryTable(), "Итоги");
+    tabs->addTab(createLeaderboardTable(), "Рекорды");
+    tabs->addTab(createRecentTable(), "Последние партии");
+    layout->addWidget(tabs, 1);
+
+    setLayout(layout);
+}
+
+QTableWidget* StatisticsWindow::createSummaryTable()
+{
+    const auto difficulties = allDifficulties();
+    QTableWidget *table = createTable({"Сложность", "Партий", "Побед", "Ходов в победе", "Лучшее время", "Лучшая серия"},
+                                      int(difficulties.size()) + 1);
+
+    auto fillRow = [table](int row, const QString& name, const HistoryStats& stats) {
+        setCell(table, row, 0, name);
+        setCell(table, row, 1, QString::number(stats.games));
+        setCell(table, row, 2, QString("%1%").arg(stats.winRate() * 100, 0, 'f', 0));
+        setCell(table, row, 3, stats.wins ? QString::number(stats.averageWinMoves(), 'f', 1) : "-");
+        setCell(table, row, 4, stats.leaderboard.isEmpty() ? "-" : formatTime(stats.leaderboard.first().timeMs));
+        setCell(table, row, 5, QString::number(stats.bestStreak));
+    };
+
+    int row = 0;
+    for (const auto& difficulty : difficulties) {
+        fillRow(row++, difficulty->getName(),
+                GameHistory::instance().boardStats(difficulty->getRows(), difficulty->getCols()));
+    }
+    fillRow(row, "Всего", GameHistory::instance().overall());
+    return table;
+}
+
+QTableWidget* StatisticsWindow::createLeaderboardTable()
+{
+    const auto difficulties = allDifficulties();
+    QStringList headers = {"Место"};
+    for (const auto& difficulty : difficulties) headers << difficulty->getName();
+
+    QTableWidget *table = createTable(headers, GameHistory::LEADERBOARD_SIZE);
+    for (int place = 0; place < GameHistory::LEADERBOARD_SIZE; ++place) {
+        setCell(table, place, 0, QString::number(place + 1));
+    }
+
+    int column = 1;
+    for (const auto& difficulty : difficulties) {
+        const HistoryStats stats = GameHistory::instance().boardStats(difficulty->getRows(), difficulty->getCols());
+        for (int place = 0; place < stats.leaderboard.size(); ++place) {
+            const BestGame& best = stats.leaderboard[place];
+            setCell(table, place, column, QString("%1, %2 ходов").arg(formatTime(best.timeMs)).arg(best.moves));
+        }
+        ++column;
+    }
+    return table;
+}
+
+QTableWidget* StatisticsWindow::createRecentTable()
+{
+    GameHistory& history = GameHistory::instance();
+    const int shown = qMin(RECENT_GAMES, history.count());
+
+    QTableWidget *table = createTable({"Дата", "Поле", "Итог", "Ходов", "Ошибок", "Время"}, shown);
+    for (int row = 0; row < shown; ++row) {
+        // Новые сверху. Запись берется из отображенного в память файла по номеру
+        const GameRecord game = history.record(history.count() - 1 - row);
+        QString outcome = game.won() ? "Победа"
+                          : game.outcome == GameOutcome::TimeOut ? "Время вышло" : "Много ошибок";
+        setCell(table, row, 0, QDateTime::fromMSecsSinceEpoch(game.finishedAt).toString("dd.MM.yyyy HH:mm"));
+        setCell(table, row, 1, QString("%1x%2").arg(game.rows).arg(game.cols));
+        setCell(table, row, 2, outcome);
+        setCell(table, row, 3, QString::number(game.moves));
+        setCell(table, row, 4, QString::number(game.mistakes));
+        setCell(table, row, 5, formatTime(game.timeMs));
+    }
+    return table;
+}
+
+void StatisticsWindow::applyStyles()
+{
+    this->setStyleSheet(R"(
+        QDialog {
+            background-color: #5f9ea0;
+            color: #800020;
+            font-family: 'Segoe UI', Arial, sans-serif;
+        }
+        #titleLabel {
+            font-size: 24px;
+            font-weight: bold;
+            color: #480607;
+        }
+        QLabel {
+            font-size: 15px;
+            font-weight: 600;
+            color: #800020;
+        }
+        QTableWidget {
+            background-color: #98f5ff;
+            color: #480607;
+            gridline-color: #7ac5cd;
+            border-radius: 5px;
+        }
+        QHeaderView::section {
+            background-color: #7ac5cd;
+            color: #800020;
+            font-weight: bold;
+            border: none;
+            padding: 4px;
+        }
+    )");
+}
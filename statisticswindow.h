@@ -0,0 +1,34 @@
+#ifndef STATISTICSWINDOW_H
+#define STATISTICSWINDOW_H
+
+#include <QDialog>
+
+class QTableWidget;
+
+// Окно "Статистика": итоги по сложностям, рекорды и последние партии.
+// Все цифры берутся из готовых итогов GameHistory, поэтому окно
+// открывается сразу при любой длине истории
+class StatisticsWindow : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit StatisticsWindow(QWidget *parent = nullptr);
+    ~StatisticsWindow();
+
+private:
+    void setupUI();
+    void applyStyles();
+
+    // Таблица итогов: строка на сложность и строка "Всего"
+    QTableWidget* createSummaryTable();
+    // Самые быстрые победы на каждой сложности
+    QTableWidget* createLeaderboardTable();
+    // Последние партии (читаются из истории по номерам)
+    QTableWidget* createRecentTable();
+
+    // Сколько последних партий показывать
+    const int RECENT_GAMES = 15;
+};
+
+#endif // STATISTICSWINDOW_H
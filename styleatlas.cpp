@@ -0,0 +1,175 @@
+#include "styleatlas.h"
+#include "resourcealiases.h"
+#include "assetpacks.h"
+
+#include <QFile>
+#include <QPainter>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <algorithm>
+
+// Читает картинку не крупнее maxSize и запоминает статистику декодирования
+static QImage readImage(const QString& path, const QSize& maxSize, QVector<DecodeStats>& stats)
+{
+    DecodeStats imageStats;
+    QImage image = ImageLoader::read(path, maxSize, &imageStats);
+    if (!image.isNull()) {
+        stats.append(imageStats);
+    }
+    return image;
+}
+
+// Имя варианта атласа: "1.png", "1@2x.png", ...
+static QString atlasPath(const QString& atlasBase, int scale)
+{
+    return scale == 1 ? atlasBase + ".png" : atlasBase + QString("@%1x.png").arg(scale);
+}
+
+StyleAtlas StyleAtlas::decode(int styleId, const QString& atlasBase, qreal devicePixelRatio)
+{
+    StyleAtlas result;
+    result.style = styleId;
+    result.dpr = devicePixelRatio;
+
+    // Размер картинки карты в пикселях устройства
+    const int cellSize = qRound(CARD_FACE_SIZE * devicePixelRatio);
+
+    // Пакет стиля подключается только когда стиль впервые понадобился
+    AssetPacks::ensureStyle(styleId);
+
+    QFile indexFile(ResourceAliases::resolve(atlasBase + ".json"));
+    if (indexFile.open(QIODevice::ReadOnly)) {
+        QJsonObject root = QJsonDocument::fromJson(indexFile.readAll()).object();
+        result.columns = root.value("columns").toInt();
+
+        QJsonObject cards = root.value("cards").toObject();
+        for (auto it = cards.constBegin(); it != cards.constEnd(); ++it) {
+            result.cardCells.insert(it.key().toInt(), it.value().toInt());
+        }
+
+        // Берем самый маленький вариант, которого хватает для этого экрана,
+        // чтобы Qt не пришлось растягивать картинку при отрисовке
+        int scale = 0;
+        int largest = 1;
+        for (const QJsonValue& value : root.value("scales").toArray()) {
+            const int available = value.toInt();
+            largest = std::max(largest, available);
+            if (available >= devicePixelRatio && (scale == 0 || available < scale)) {
+                scale = available;
+            }
+        }
+        if (scale == 0) scale = largest;
+
+        // Одно декодирование на весь стиль вместо отдельной PNG на каждую карту.
+        // Если ячейки атласа крупнее нужного - читаем его сразу уменьшенным
+        int cells = 0;
+        for (int cell : std::as_const(result.cardCells)) cells = std::max(cells, cell + 1);
+        const int rows = result.columns > 0 ? (cells + result.columns - 1) / result.columns : 0;
+        result.atlasImage = readImage(atlasPath(atlasBase, scale),
+                                      QSize(result.columns * cellSize, rows * cellSize), result.stats);
+        return result;
+    }
+
+    // Атласа нет - читаем карты по одной (до 12 штук в стиле), сразу в размере карты
+    for (int cardId = 1; cardId <= 12; ++cardId) {
+        QString path = QString(":/images/%1 - image%2.png").arg(styleId).arg(cardId);
+        if (!QFile::exists(ResourceAliases::resolve(path))) continue;
+
+        QImage image = readImage(path, QSize(cellSize, cellSize), result.stats);
+        if (!image.isNull()) {
+            result.looseImages.insert(cardId, image);
+        }
+    }
+    return result;
+}
+
+void StyleAtlas::upload()
+{
+    if (!atlasImage.isNull()) {
+        atlas = QPixmap::fromImage(atlasImage);
+        atlasImage = QImage();
+    }
+    for (auto it = looseImages.constBegin(); it != looseImages.constEnd(); ++it) {
+        looseCards.insert(it.key(), QPixmap::fromImage(it.value()));
+    }
+    looseImages.clear();
+}
+
+StyleAtlas StyleAtlas::load(int styleId, const QString& atlasBase, qreal devicePixelRatio)
+{
+    StyleAtlas result = decode(styleId, atlasBase, devicePixelRatio);
+    result.upload();
+    return result;
+}
+
+bool StyleAtlas::isNull() const
+{
+    return atlas.isNull() && looseCards.isEmpty();
+}
+
+QRect StyleAtlas::sourceRect(int cardId) const
+{
+    auto it = cardCells.constFind(cardId);
+    if (atlas.isNull() || it == cardCells.constEnd() || columns <= 0) {
+        return QRect();
+    }
+
+    // Атлас может быть @2x/@3x, поэтому размер ячейки считаем по его ширине
+    const int cell = atlas.width() / columns;
+    return QRect((it.value() % columns) * cell, (it.value() / columns) * cell, cell, cell);
+}
+
+int StyleAtlas::canonicalCard(int cardId) const
+{
+    // Одинаковые карты лежат в одной ячейке атласа - берем наименьший номер карты в ней
+    auto it = cardCells.constFind(cardId);
+    if (it == cardCells.constEnd()) return cardId;
+
+    int canonical = cardId;
+    for (auto other = cardCells.constBegin(); other != cardCells.constEnd(); ++other) {
+        if (other.value() == it.value() && other.key() < canonical) {
+            canonical = other.key();
+        }
+    }
+    return canonical;
+}
+
+bool StyleAtlas::drawCard(QPainter& painter, const QRect& target, int cardId) const
+{
+    if (!looseCards.isEmpty()) {
+        auto it = looseCards.constFind(cardId);
+        if (it == looseCards.constEnd()) return false;
+        painter.drawPixmap(target, it.value());
+        return true;
+    }
+
+    QRect rect = sourceRect(cardId);
+    if (rect.isNull()) return false;
+    // Ячейка атласа уже в пикселях устройства для этого экрана,
+    // поэтому Qt копирует ее без масштабирования
+    painter.drawPixmap(target, atlas, rect);
+    return true;
+}
+
+QPixmap StyleAtlas::card(int cardId) const
+{
+    if (!looseCards.isEmpty()) {
+        return looseCards.value(cardId);
+    }
+
+    QRect rect = sourceRect(cardId);
+    if (rect.isNull()) {
+        return QPixmap();
+    }
+    return atlas.copy(rect);
+}
+
+qint64 StyleAtlas::byteSize() const
+{
+    qint64 bytes = qint64(atlas.width()) * atlas.height() * atlas.depth() / 8;
+    for (const QPixmap& pix : looseCards) {
+        bytes += qint64(pix.width()) * pix.height() * pix.depth() / 8;
+    }
+    return bytes;
+}
@@ -0,0 +1,93 @@
+#ifndef STYLEATLAS_H
+#define STYLEATLAS_H
+
+#include <QPixmap>
+#include <QImage>
+#include <QRect>
+#include <QHash>
+#include <QVector>
+
+#include "imageloader.h"
+
+class QPainter;
+
+// Размер карты на экране в логических пикселях
+const int CARD_SIZE = 100;
+// Отступ картинки внутри карты и размер самой картинки.
+// В этом размере картинки готовит Memory_assettool (MEMORY_CARD_FACE_SIZE
+// в CMakeLists.txt), чтобы поле рисовало их из атласа без масштабирования
+const int CARD_MARGIN = 5;
+const int CARD_FACE_SIZE = CARD_SIZE - 2 * CARD_MARGIN;
+
+// Атлас карт одного стиля: все картинки стиля склеены в одну PNG,
+// а индекс хранит, в какой ячейке лежит каждая карта.
+// Атлас и индекс готовит Memory_assettool при сборке (":/atlases/N.png" + ".json"),
+// у внешних пакетов стилей они лежат в папке пакета (см. StyleCatalog).
+// Если атласа нет (сборка без MEMORY_PRESCALE_ASSETS), карты читаются
+// по отдельности из ":/images/N - imageK.png".
+//
+// Загрузка делится на два шага: decode() можно вызывать из рабочего потока
+// (там только QImage), а upload() переводит картинки в QPixmap в GUI-потоке.
+class StyleAtlas
+{
+public:
+    StyleAtlas() = default;
+
+    // Читает индекс и декодирует PNG (безопасно для рабочего потока).
+    // atlasBase - путь к атласу без расширения (StyleInfo::atlasBase).
+    // Для devicePixelRatio > 1 берется вариант атласа @2x/@3x, а если ячейки
+    // в нем крупнее CARD_FACE_SIZE * devicePixelRatio - он сразу декодируется уменьшенным
+    static StyleAtlas decode(int styleId, const QString& atlasBase, qreal devicePixelRatio = 1.0);
+
+    // Переводит декодированные картинки в QPixmap (только GUI-поток)
+    void upload();
+
+    // decode() + upload() за один вызов
+    static StyleAtlas load(int styleId, const QString& atlasBase, qreal devicePixelRatio = 1.0);
+
+    bool isNull() const;
+    int styleId() const { return style; }
+    qreal devicePixelRatio() const { return dpr; }
+
+    // Весь атлас целиком (для рисования через QPainter с sourceRect)
+    const QPixmap& pixmap() const { return atlas; }
+
+    // Прямоугольник карты внутри атласа (в пикселях самой картинки атласа)
+    QRect sourceRect(int cardId) const;
+
+    // Рисует карту в прямоугольник target прямо из атласа (по sourceRect),
+    // без отдельной картинки на каждую карту. false - такой карты в стиле нет
+    bool drawCard(QPainter& painter, const QRect& target, int cardId) const;
+
+    // Отдельная картинка карты (копия ячейки атласа). Только для превью
+    // магазина, поле рисует карты через drawCard
+    QPixmap card(int cardId) const;
+
+    // Номер карты с той же картинкой (одинаковые карты хранятся в атласе один раз).
+    // По нему кэш делит одну декодированную картинку между всеми такими картами
+    int canonicalCard(int cardId) const;
+
+    // Сколько памяти занимают декодированные картинки стиля
+    qint64 byteSize() const;
+
+    // Время и пиковая память декодирования каждой PNG этого стиля
+    const QVector<DecodeStats>& decodeStats() const { return stats; }
+
+private:
+    int style = 0;
+    qreal dpr = 1.0;
+    int columns = 0;
+    QPixmap atlas;
+    QHash<int, int> cardCells; // номер карты -> номер ячейки
+
+    // Запасной вариант: карты без атласа, по одной картинке
+    QHash<int, QPixmap> looseCards;
+
+    // Результат decode() до вызова upload()
+    QImage atlasImage;
+    QHash<int, QImage> looseImages;
+
+    QVector<DecodeStats> stats;
+};
+
+#endif // STYLEATLAS_H
@@ -0,0 +1,131 @@
+#include "stylecatalog.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <algorithm>
+
+// На самой сложной сложности поле 6x4, то есть нужно 12 разных карт
+const int MIN_CARDS_PER_STYLE = 12;
+
+// Встроенный стиль: картинки в ресурсах exe (или в assets/style_N.rcc)
+static StyleInfo builtInStyle(int id, const QString& name, int cost, const QString& colorHex,
+                              const QColor& top, const QColor& bottom, const QColor& border)
+{
+    StyleInfo style;
+    style.id = id;
+    style.name = name;
+    style.cost = cost;
+    style.colorHex = colorHex;
+    style.backTop = top;
+    style.backBottom = bottom;
+    style.border = border;
+    style.atlasBase = QString(":/atlases/%1").arg(id);
+    style.builtIn = true;
+    return style;
+}
+
+StyleCatalog::StyleCatalog()
+{
+    add(builtInStyle(1, "Ам-Ням", 0, "#7ED957", QColor("#FFB6F772"), QColor("#FF7ED957"), QColor("#FF3F9E2F")));
+    add(builtInStyle(2, "Фрукты", 10000, "#4facfe", QColor("#4facfe"), QColor("#00f2fe"), QColor("#00c6fb")));
+    add(builtInStyle(3, "Игрушки", 10000, "#fa709a", QColor("#fa709a"), QColor("#fee140"), QColor("#fa709a")));
+    add(builtInStyle(4, "Животные", 10000, "#ffff99", QColor("#ffff99"), QColor("#78866b"), QColor("#ffff99")));
+}
+
+StyleCatalog& StyleCatalog::instance()
+{
+    static StyleCatalog catalog;
+    return catalog;
+}
+
+void StyleCatalog::add(const StyleInfo& style)
+{
+    auto existing = indexById.constFind(style.id);
+    if (existing != indexById.constEnd()) {
+        list[existing.value()] = style;
+        return;
+    }
+
+    // Держим список отсортированным по id, чтобы магазин показывал стили по порядку
+    auto position = std::lower_bound(list.begin(), list.end(), style.id,
+                                     [](const StyleInfo& a, int id) { return a.id < id; });
+    list.insert(position, style);
+
+    indexById.clear();
+    for (int i = 0; i < list.size(); ++i) {
+        indexById.insert(list[i].id, i);
+    }
+}
+
+void StyleCatalog::scan(const QString& directory)
+{
+    QDir root(directory);
+    if (!root.exists()) return;
+
+    for (const QString& folder : root.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        QDir packDir(root.filePath(folder));
+
+        QFile manifestFile(packDir.filePath("manifest.json"));
+        if (!manifestFile.open(QIODevice::ReadOnly)) continue;
+
+        QJsonParseError error;
+        QJsonObject manifest = QJsonDocument::fromJson(manifestFile.readAll(), &error).object();
+        if (error.error != QJsonParseError::NoError) {
+            qWarning() << "StyleCatalog:" << manifestFile.fileName() << error.errorString();
+            continue;
+        }
+
+        StyleInfo style;
+        style.id = manifest.value("id").toInt();
+        style.name = manifest.value("name").toString(folder);
+        style.cost = manifest.value("cost").toInt();
+        style.colorHex = manifest.value("color").toString("#98f5ff");
+
+        QJsonObject back = manifest.value("back").toObject();
+        style.backTop = QColor(back.value("top").toString("#98f5ff"));
+        style.backBottom = QColor(back.value("bottom").toString("#7ac5cd"));
+        style.border = QColor(back.value("border").toString("#53868b"));
+
+        style.atlasBase = packDir.filePath(manifest.value("atlas").toString("atlas"));
+        style.builtIn = false;
+
+        if (style.id <= 0) {
+            qWarning() << "StyleCatalog:" << folder << "- не указан id стиля";
+            continue;
+        }
+        if (indexById.contains(style.id) && list[indexById.value(style.id)].builtIn) {
+            qWarning() << "StyleCatalog:" << folder << "- id" << style.id << "занят встроенным стилем";
+            continue;
+        }
+
+        // Проверяем только индекс атласа, саму картинку не декодируем
+        QFile indexFile(style.atlasBase + ".json");
+        if (!indexFile.open(QIODevice::ReadOnly)) {
+            qWarning() << "StyleCatalog:" << folder << "- нет" << indexFile.fileName();
+            continue;
+        }
+        QJsonObject cards = QJsonDocument::fromJson(indexFile.readAll()).object().value("cards").toObject();
+        if (cards.size() < MIN_CARDS_PER_STYLE) {
+            qWarning() << "StyleCatalog:" << folder << "- в стиле" << cards.size()
+                       << "карт, нужно не меньше" << MIN_CARDS_PER_STYLE;
+            continue;
+        }
+
+        add(style);
+    }
+}
+
+const StyleInfo* StyleCatalog::find(int styleId) const
+{
+    auto it = indexById.constFind(styleId);
+    return it == indexById.constEnd() ? nullptr : &list[it.value()];
+}
+
+const StyleInfo& StyleCatalog::styleOrDefault(int styleId) const
+{
+    const StyleInfo* style = find(styleId);
+    return style ? *style : list.first();
+}
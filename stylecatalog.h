@@ -0,0 +1,70 @@
+#ifndef STYLECATALOG_H
+#define STYLECATALOG_H
+
+#include <QString>
+#include <QColor>
+#include <QList>
+#include <QHash>
+
+// Описание одного стиля карт
+struct StyleInfo {
+    int id = 0;
+    QString name;
+    int cost = 0;        // цена в магазине (0 - доступен сразу)
+    QString colorHex;    // цвет стиля в магазине
+
+    // Рубашка карты: вертикальный градиент и рамка
+    QColor backTop;
+    QColor backBottom;
+    QColor border;
+
+    // Путь к атласу без расширения: ":/atlases/1" для встроенных стилей,
+    // "<папка пакета>/atlas" для внешних (рядом лежат atlas.json, atlas.png, atlas@2x.png...)
+    QString atlasBase;
+    bool builtIn = true;
+};
+
+// Каталог стилей карт.
+// Встроенные стили описаны в stylecatalog.cpp, дополнительные (сезонные наборы)
+// лежат в папке "styles" рядом с exe, каждый в своей подпапке:
+//
+//   styles/winter/manifest.json   - описание стиля (см. ниже)
+//   styles/winter/atlas.json      - индекс атласа в формате Memory_assettool
+//   styles/winter/atlas.png       - атлас (и atlas@2x.png, atlas@3x.png)
+//
+// manifest.json:
+//   { "id": 101, "name": "Зима", "cost": 15000, "color": "#a0c4ff",
+//     "back": { "top": "#dfe9f3", "bottom": "#ffffff", "border": "#9bb0c8" },
+//     "atlas": "atlas" }
+//
+// При старте читаются только манифесты и индексы (без декодирования картинок),
+// сами атласы загружает ImageCache, когда стиль понадобился.
+class StyleCatalog
+{
+public:
+    static StyleCatalog& instance();
+
+    // Ищет пакеты стилей в папке. Вызывается один раз при старте
+    void scan(const QString& directory);
+
+    // Все стили по возрастанию id
+    const QList<StyleInfo>& styles() const { return list; }
+
+    // Стиль по id (nullptr, если такого нет)
+    const StyleInfo* find(int styleId) const;
+
+    // Стиль по id или первый встроенный, если такого нет
+    const StyleInfo& styleOrDefault(int styleId) const;
+
+private:
+    StyleCatalog();
+    StyleCatalog(const StyleCatalog&) = delete;
+    StyleCatalog& operator=(const StyleCatalog&) = delete;
+
+    void add(const StyleInfo& style);
+
+    QList<StyleInfo> list;
+    QHash<int, int> indexById; // id -> позиция в list
+};
+
+#endif // STYLECATALOG_H
@@ -1,23 +1,33 @@
 #include "styleswindow.h"
+#include "imagecache.h"
+#include "stylecatalog.h"
+#include "settingsstore.h"
+#include "coinledger.h"
 
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
+#include <QScrollArea>
 #include <QMessageBox>
 #include <QDebug>
 #include <QApplication>
 
-const int STYLE_COST = 10000;
-const int TOTAL_STYLES = 3;
 
-StylesWindow::StylesWindow(int currentCoins, QWidget *parent)
+StylesWindow::StylesWindow(QWidget *parent)
     : QDialog(parent)
-    , currentCoins(currentCoins)
-    , settings(qApp->applicationDirPath() + "/save.ini", QSettings::IniFormat)
+    , settings(SettingsStore::instance())
 {
     setupUI();
     applyStyles();
+
+    // Превью всех стилей декодируются в фоне, окно открывается сразу
+    connect(&ImageCache::instance(), &ImageCache::styleReady, this, &StylesWindow::updatePreview);
+    connect(&ImageCache::instance(), &ImageCache::styleFailed, this, &StylesWindow::showMissingPreview);
+    for (const StyleInfo& style : StyleCatalog::instance().styles()) {
+        ImageCache::instance().prefetch(style.id, devicePixelRatioF());
+    }
+
     refreshGrid();
 }
 
@@ -42,7 +52,7 @@ void StylesWindow::setupUI()
 
     topBarLayout->addStretch(1);
 
-    coinDisplayLabel = new QLabel(QString("💰 %1").arg(currentCoins));
+    coinDisplayLabel = new QLabel(QString("💰 %1").arg(CoinLedger::instance().balance()));
     coinDisplayLabel->setObjectName("coinDisplayLabel");
     topBarLayout->addWidget(coinDisplayLabel);
 
@@ -52,7 +62,14 @@ void StylesWindow::setupUI()
     stylesGridLayout = new QGridLayout(gridContainer);
     stylesGridLayout->setSpacing(15);
 
-    mainLayout->addWidget(gridContainer, 1);
+    // Стилей может быть больше четырех (пакеты из папки styles), поэтому сетка прокручивается
+    QScrollArea *scrollArea = new QScrollArea();
+    scrollArea->setWidget(gridContainer);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setFrameShape(QFrame::NoFrame);
+    scrollArea->setStyleSheet("QScrollArea { background: transparent; } QScrollArea > QWidget > QWidget { background: transparent; }");
+
+    mainLayout->addWidget(scrollArea, 1);
 
     setLayout(mainLayout);
 }
@@ -60,6 +77,7 @@ void StylesWindow::setupUI()
 void StylesWindow::refreshGrid()
 {
     // Удаляем все старые виджеты из сетки, чтобы пересоздать их
+    previewLabels.clear();
     QLayoutItem *child;
     while ((child = stylesGridLayout->takeAt(0)) != nullptr) {
         if (child->widget()) {
@@ -68,17 +86,13 @@ void StylesWindow::refreshGrid()
         delete child;
     }
 
-    // Загружаем список купленных стилей из строки "1,2,3"
-    QString unlockedStr = settings.value("unlocked_styles", "1").toString();
-    QStringList unlockedList = unlockedStr.split(",");
-
-    int currentStyle = settings.value("current_style", 1).toInt();
-
-    // Создаем карточки товаров и добавляем их в таблицу
-    stylesGridLayout->addWidget(createStyleCard(1, 0, "Ам-Ням", "#7ED957"), 0, 0);
-    stylesGridLayout->addWidget(createStyleCard(2, 10000, "Фрукты", "#4facfe"), 0, 1);
-    stylesGridLayout->addWidget(createStyleCard(3, 10000, "Игрушки", "#fa709a"), 1, 0);
-    stylesGridLayout->addWidget(createStyleCard(4, 10000, "Животные", "#ffff99"), 1, 1);
+    // Создаем карточки товаров из каталога стилей и добавляем их в таблицу (по 2 в ряд)
+    int index = 0;
+    for (const StyleInfo& style : StyleCatalog::instance().styles()) {
+        stylesGridLayout->addWidget(createStyleCard(style.id, style.cost, style.name, style.colorHex),
+                                    index / 2, index % 2);
+        ++index;
+    }
 }
 
 QWidget* StylesWindow::createStyleCard(int styleId, int cost, const QString& name, const QString& colorHex)
@@ -86,11 +100,8 @@ QWidget* StylesWindow::createStyleCard(int styleId, int cost, const QString& nam
     QWidget *card = new QWidget();
     card->setFixedSize(160, 220);
 
-    QString unlockedStr = settings.value("unlocked_styles", "1").toString();
-    QStringList unlockedList = unlockedStr.split(",");
-
-    // Проверяем, куплен ли стиль и выбран ли он сейчас
-    bool isUnlocked = unlockedList.contains(QString::number(styleId));
+    // Проверяем, куплен ли стиль (покупки хранит журнал монет) и выбран ли он сейчас
+    bool isUnlocked = CoinLedger::instance().isStyleUnlocked(styleId);
     int currentStyle = settings.value("current_style", 1).toInt();
     bool isSelected = (currentStyle == styleId);
 
@@ -108,15 +119,8 @@ QWidget* StylesWindow::createStyleCard(int styleId, int cost, const QString& nam
     QLabel *imgLabel = new QLabel();
     imgLabel->setFixedSize(130, 100);
     imgLabel->setAlignment(Qt::AlignCenter);
-
-    QString imgPath = QString("://images/%1 - image1.png").arg(styleId);
-    QPixmap pix(imgPath);
-    if (!pix.isNull()) {
-        imgLabel->setPixmap(pix.scaled(130, 100, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-    } else {
-        imgLabel->setText("Нет картинки\n" + imgPath);
-        imgLabel->setStyleSheet("font-size: 10px; color: #aaa;");
-    }
+    previewLabels.insert(styleId, imgLabel);
+    updatePreview(styleId);
     layout->addWidget(imgLabel);
 
     // 2. Название
@@ -152,31 +156,53 @@ QWidget* StylesWindow::createStyleCard(int styleId, int cost, const QString& nam
     return card;
 }
 
-void StylesWindow::onStyleClicked(int styleId, int cost)
+void StylesWindow::updatePreview(int styleId)
 {
-    QString unlockedStr = settings.value("unlocked_styles", "1").toString();
-    QStringList unlockedList = unlockedStr.split(",");
-    bool isUnlocked = unlockedList.contains(QString::number(styleId));
+    QLabel *imgLabel = previewLabels.value(styleId);
+    if (!imgLabel) return;
+
+    // Стиль еще декодируется - картинка появится по сигналу styleReady.
+    // Если прошлая попытка не удалась, prefetch пробует снова
+    if (!ImageCache::instance().isStyleReady(styleId, devicePixelRatioF())) {
+        ImageCache::instance().prefetch(styleId, devicePixelRatioF());
+        return;
+    }
 
-    if (isUnlocked) {
+    // Превью - первая карта стиля
+    // Берем из общего кэша, чтобы при повторном открытии магазина не декодировать снова
+    QPixmap pix = ImageCache::instance().cardPixmap(styleId, 1, QSize(130, 100), devicePixelRatioF());
+    if (!pix.isNull()) {
+        imgLabel->setPixmap(pix);
+    } else {
+        showMissingPreview(styleId);
+    }
+}
+
+void StylesWindow::showMissingPreview(int styleId)
+{
+    QLabel *imgLabel = previewLabels.value(styleId);
+    if (!imgLabel) return;
+
+    QString imgPath = QString(":/atlases/%1.png").arg(styleId);
+    imgLabel->setText("Нет картинки\n" + imgPath);
+    imgLabel->setStyleSheet("font-size: 10px; color: #aaa;");
+}
+
+void StylesWindow::onStyleClicked(int styleId, int cost)
+{
+    if (CoinLedger::instance().isStyleUnlocked(styleId)) {
         // Если уже куплено - просто делаем этот стиль текущим
         settings.setValue("current_style", styleId);
         refreshGrid();
     } else {
         // Логика покупки
-        if (currentCoins >= cost) {
-            currentCoins -= cost;
-            emit coinsChanged(currentCoins); // Сообщаем в главное меню
-
-            settings.setValue("coins", currentCoins);
-
-            // Добавляем ID стиля в список купленных
-            unlockedList.append(QString::number(styleId));
-            settings.setValue("unlocked_styles", unlockedList.join(","));
-
+        // Списание и открытие стиля - одна запись в журнале монет,
+        // главное меню узнает о списании само
+        if (CoinLedger::instance().buyStyle(styleId, cost)) {
+            // Выбор стиля - обычная настройка: если она потеряется, стиль все равно куплен
             settings.setValue("current_style", styleId);
 
-            coinDisplayLabel->setText(QString("💰 %1").arg(currentCoins));
+            coinDisplayLabel->setText(QString("💰 %1").arg(CoinLedger::instance().balance()));
             QMessageBox::information(this, "Успех", "Стиль успешно куплен!");
             refreshGrid();
         } else {
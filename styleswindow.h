@@ -3,24 +3,23 @@
 
 #include <QDialog>
 #include <QGridLayout>
-#include <QSettings>
+#include <QHash>
 
 class QLabel;
 class QPushButton;
+class SettingsStore;
 
 // Окно "Стили" (Магазин), где можно купить новые рубашки карт
 class StylesWindow : public QDialog
 {
     Q_OBJECT
+    // Замеры производительности вызывают внутренние методы напрямую (tools/benchmark.cpp)
+    friend class MemoryBenchmark;
 
 public:
-    explicit StylesWindow(int currentCoins, QWidget *parent = nullptr);
+    explicit StylesWindow(QWidget *parent = nullptr);
     ~StylesWindow();
 
-signals:
-    // Сообщаем главному окну, что количество монет изменилось (после покупки)
-    void coinsChanged(int newCoins);
-
 private slots:
     // Обработка клика по карточке товара
     void onStyleClicked(int styleId, int cost);
@@ -36,12 +35,19 @@ private:
     // Создает виджет одной карточки товара
     QWidget* createStyleCard(int styleId, int cost, const QString& name, const QString& colorHex);
 
-    int currentCoins;
+    // Ставит картинку превью, когда стиль декодирован в фоне
+    void updatePreview(int styleId);
+    // Надпись вместо превью, если картинки стиля не загрузились
+    void showMissingPreview(int styleId);
+
     QLabel *coinDisplayLabel;
     QGridLayout *stylesGridLayout;
     QWidget *gridContainer;
+    // Картинки превью по номеру стиля (заполняются в refreshGrid)
+    QHash<int, QLabel*> previewLabels;
 
-    QSettings settings;
+    // Сохранения игры (общие для всех окон, см. SettingsStore)
+    SettingsStore& settings;
 };
 
 #endif
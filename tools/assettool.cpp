@@ -0,0 +1,364 @@
+// Утилита сборки ресурсов игры.
+// Запускается из CMake во время сборки: читает memory_game.qrc, заранее уменьшает
+// картинки карт до размера картинки на карте (плюс варианты @2x/@3x для HiDPI экранов),
+// склеивает карты каждого стиля в один атлас и пишет новый .qrc,
+// который уже встраивается в исполняемый файл.
+//
+// Атлас стиля N лежит в ":/atlases/N.png" (и N@2x.png, N@3x.png),
+// а индекс (номер карты -> ячейка атласа) в ":/atlases/N.json".
+//
+// Одинаковые по содержимому файлы хранятся один раз:
+// - одинаковые карты стиля занимают одну ячейку атласа (в индексе у них общий номер ячейки);
+// - для остальных повторов пишется таблица псевдонимов ":/aliases.json"
+//   (путь-повтор -> путь к единственной копии), ее читает ResourceAliases.
+//
+// С флагом --split-packs вместо одного .qrc пишется набор пакетов:
+// <name>_core.qrc (звуки, иконки, таблица псевдонимов) и <name>_style_N.qrc
+// на каждый стиль. Из них CMake собирает внешние .rcc (см. AssetPacks).
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QImageReader>
+#include <QImage>
+#include <QPainter>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+#include <QMap>
+#include <QHash>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QList>
+#include <QTextStream>
+
+// Одна запись <file> из исходного .qrc
+struct ResourceEntry {
+    QString prefix;   // "/images", "/audios", ...
+    QString fileName; // путь к файлу относительно .qrc
+};
+
+// Одна запись <file> в сгенерированном .qrc
+struct OutputEntry {
+    QString pack;   // "core" или "style_N"
+    QString prefix; // "/atlases", "/audios", ...
+    QString alias;  // имя внутри prefix
+    QString path;   // файл на диске (абсолютный или относительно выходной папки)
+};
+
+static QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Разбираем исходный .qrc и собираем список всех файлов
+static bool readQrc(const QString& qrcPath, QList<ResourceEntry>& entries)
+{
+    QFile file(qrcPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        err() << "assettool: не удалось открыть " << qrcPath << Qt::endl;
+        return false;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString prefix;
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (!xml.isStartElement()) continue;
+
+        if (xml.name() == QLatin1String("qresource")) {
+            prefix = xml.attributes().value("prefix").toString();
+        } else if (xml.name() == QLatin1String("file")) {
+            entries.append({prefix, xml.readElementText().trimmed()});
+        }
+    }
+
+    if (xml.hasError()) {
+        err() << "assettool: ошибка разбора " << qrcPath << ": " << xml.errorString() << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+// Хэш содержимого файла (пустой, если файл не читается)
+static QByteArray contentHash(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        err() << "assettool: не удалось открыть " << path << Qt::endl;
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(&file);
+    return hash.result();
+}
+
+// Имя варианта для HiDPI: "1 - image1.png" -> "1 - image1@2x.png"
+static QString scaledName(const QString& fileName, int scale)
+{
+    if (scale == 1) return fileName;
+    QFileInfo info(fileName);
+    return info.completeBaseName() + QString("@%1x.").arg(scale) + info.suffix();
+}
+
+// Читаем картинку и уменьшаем ее до размера картинки карты
+static QImage loadScaled(const QString& sourcePath, int targetSize)
+{
+    QImageReader reader(sourcePath);
+    QImage image = reader.read();
+    if (image.isNull()) {
+        err() << "assettool: не удалось прочитать " << sourcePath << ": " << reader.errorString() << Qt::endl;
+        return QImage();
+    }
+
+    // Маленькие картинки не растягиваем, крупные уменьшаем с сохранением пропорций
+    if (image.width() > targetSize || image.height() > targetSize) {
+        image = image.scaled(targetSize, targetSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    // Приводим к формату, который QPixmap рисует без дополнительной конвертации
+    return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                         : QImage::Format_RGB32);
+}
+
+static bool saveImage(const QImage& image, const QString& targetPath)
+{
+    if (!image.save(targetPath, "PNG")) {
+        err() << "assettool: не удалось записать " << targetPath << Qt::endl;
+        return false;
+    }
+    return true;
+}
+
+// Карты одного стиля: номер карты -> исходный файл
+using StyleCards = QMap<int, QString>;
+
+// Склеиваем карты стиля в атласы (по одному на каждый масштаб) и пишем индекс
+static bool bakeAtlas(int styleId, const StyleCards& cards, const QDir& outDir,
+                      int cardSize, const QList<int>& scales, QList<OutputEntry>& outputs)
+{
+    // Одинаковые по содержимому карты кладем в одну ячейку
+    QHash<QByteArray, int> cellByHash;
+    QMap<int, int> cardCells; // номер карты -> номер ячейки
+    QList<QString> cellSources; // номер ячейки -> исходный файл
+    for (auto it = cards.cbegin(); it != cards.cend(); ++it) {
+        const QByteArray hash = contentHash(it.value());
+        if (hash.isEmpty()) return false;
+
+        auto cell = cellByHash.constFind(hash);
+        if (cell == cellByHash.constEnd()) {
+            cell = cellByHash.insert(hash, cellSources.size());
+            cellSources.append(it.value());
+        }
+        cardCells.insert(it.key(), cell.value());
+    }
+
+    const int columns = qMin(4, int(cellSources.size()));
+    const int rows = (cellSources.size() + columns - 1) / columns;
+    const QString baseName = QString::number(styleId);
+
+    for (int scale : scales) {
+        const int cell = cardSize * scale;
+        QImage atlas(columns * cell, rows * cell, QImage::Format_ARGB32_Premultiplied);
+        atlas.fill(Qt::transparent);
+
+        QPainter painter(&atlas);
+        for (int index = 0; index < cellSources.size(); ++index) {
+            QImage image = loadScaled(cellSources[index], cell);
+            if (image.isNull()) return false;
+
+            // Картинку центрируем в ячейке, если она не квадратная
+            QPoint cellOrigin((index % columns) * cell, (index / columns) * cell);
+            QPoint offset((cell - image.width()) / 2, (cell - image.height()) / 2);
+            painter.drawImage(cellOrigin + offset, image);
+        }
+        painter.end();
+
+        const QString name = scaledName(baseName + ".png", scale);
+        if (!saveImage(atlas, outDir.filePath("atlases/" + name))) return false;
+        outputs.append({"style_" + baseName, "/atlases", name, "atlases/" + name});
+    }
+
+    // Индекс: размер ячейки в логических пикселях и номер ячейки для каждой карты
+    QJsonObject cardIndex;
+    for (auto it = cardCells.cbegin(); it != cardCells.cend(); ++it) {
+        cardIndex.insert(QString::number(it.key()), it.value());
+    }
+    QJsonArray scaleList;
+    for (int scale : scales) scaleList.append(scale);
+
+    QJsonObject root;
+    root.insert("style", styleId);
+    root.insert("cellSize", cardSize);
+    root.insert("columns", columns);
+    root.insert("scales", scaleList);
+    root.insert("cards", cardIndex);
+
+    QFile indexFile(outDir.filePath("atlases/" + baseName + ".json"));
+    if (!indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err() << "assettool: не удалось записать " << indexFile.fileName() << Qt::endl;
+        return false;
+    }
+    indexFile.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    outputs.append({"style_" + baseName, "/atlases", baseName + ".json", "atlases/" + baseName + ".json"});
+
+    if (cellSources.size() < cards.size()) {
+        err() << "assettool: стиль " << styleId << ": " << cards.size() << " карт, уникальных "
+              << cellSources.size() << Qt::endl;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Подготовка ресурсов Memory к встраиванию");
+    parser.addHelpOption();
+    QCommandLineOption qrcOption("qrc", "Исходный .qrc файл.", "file");
+    QCommandLineOption outOption("out", "Папка для сгенерированных файлов.", "dir");
+    QCommandLineOption nameOption("name", "Имя сгенерированного .qrc (без расширения).", "name", "memory_game_assets");
+    QCommandLineOption sizeOption("size", "Размер картинки карты в логических пикселях.", "px", "90");
+    QCommandLineOption scalesOption("scales", "Масштабы для HiDPI через запятую.", "list", "1,2,3");
+    QCommandLineOption splitOption("split-packs", "Писать отдельный .qrc на каждый стиль (для внешних .rcc).");
+    parser.addOptions({qrcOption, outOption, nameOption, sizeOption, scalesOption, splitOption});
+    parser.process(app);
+
+    if (!parser.isSet(qrcOption) || !parser.isSet(outOption)) {
+        parser.showHelp(1);
+    }
+
+    const QString qrcPath = QFileInfo(parser.value(qrcOption)).absoluteFilePath();
+    const QDir sourceDir = QFileInfo(qrcPath).absoluteDir();
+    const QDir outDir(parser.value(outOption));
+    const int cardSize = parser.value(sizeOption).toInt();
+
+    QList<int> scales;
+    for (const QString& s : parser.value(scalesOption).split(',', Qt::SkipEmptyParts)) {
+        scales.append(s.toInt());
+    }
+    if (cardSize <= 0 || scales.isEmpty()) {
+        err() << "assettool: неверные параметры --size/--scales" << Qt::endl;
+        return 1;
+    }
+
+    QList<ResourceEntry> entries;
+    if (!readQrc(qrcPath, entries)) return 1;
+
+    if (!outDir.mkpath("images") || !outDir.mkpath("atlases")) {
+        err() << "assettool: не удалось создать " << outDir.absolutePath() << Qt::endl;
+        return 1;
+    }
+
+    // Имена карт вида "2 - image7.png": стиль 2, карта 7
+    static const QRegularExpression cardPattern("^(\\d+) - image(\\d+)\\.png$");
+    QMap<int, StyleCards> styles;
+    QList<OutputEntry> outputs;
+
+    for (const ResourceEntry& entry : entries) {
+        const QString sourcePath = sourceDir.absoluteFilePath(entry.fileName);
+        QRegularExpressionMatch match = cardPattern.match(entry.fileName);
+
+        if (entry.prefix == QLatin1String("/images") && match.hasMatch()) {
+            // Карты стилей собираем в атласы ниже
+            styles[match.captured(1).toInt()].insert(match.captured(2).toInt(), sourcePath);
+        } else if (entry.prefix == QLatin1String("/images")) {
+            // Отдельные картинки (не карты) просто уменьшаем
+            for (int scale : scales) {
+                const QString name = scaledName(entry.fileName, scale);
+                QImage image = loadScaled(sourcePath, cardSize * scale);
+                if (image.isNull() || !saveImage(image, outDir.filePath("images/" + name))) return 1;
+                outputs.append({"core", entry.prefix, name, "images/" + name});
+            }
+        } else {
+            // Звуки и иконки не трогаем, ссылаемся на исходный файл
+            outputs.append({"core", entry.prefix, entry.fileName, sourcePath});
+        }
+    }
+
+    for (auto style = styles.cbegin(); style != styles.cend(); ++style) {
+        if (!bakeAtlas(style.key(), style.value(), outDir, cardSize, scales, outputs)) return 1;
+    }
+
+    // Пишем новый .qrc (или по одному на пакет), каждый уникальный по содержимому файл - один раз.
+    // Псевдоним может ссылаться только на копию в том же пакете, иначе пакет
+    // стиля зависел бы от того, подключен ли другой пакет
+    const bool splitPacks = parser.isSet(splitOption);
+    QMap<QString, QList<OutputEntry>> packs;
+    for (const OutputEntry& output : outputs) {
+        packs[splitPacks ? output.pack : QString()].append(output);
+    }
+
+    QJsonObject aliases; // путь-повтор -> путь к копии
+    for (auto pack = packs.cbegin(); pack != packs.cend(); ++pack) {
+        const QString qrcName = parser.value(nameOption) + (pack.key().isEmpty() ? "" : "_" + pack.key());
+        QFile qrcOut(outDir.filePath(qrcName + ".qrc"));
+        if (!qrcOut.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err() << "assettool: не удалось записать " << qrcOut.fileName() << Qt::endl;
+            return 1;
+        }
+
+        QXmlStreamWriter xml(&qrcOut);
+        xml.setAutoFormatting(true);
+        xml.writeStartElement("RCC");
+
+        QHash<QByteArray, QString> resourceByHash; // хэш -> путь в ресурсах
+        QString currentPrefix;
+        bool prefixOpen = false;
+
+        for (const OutputEntry& output : pack.value()) {
+            const QString resourcePath = output.prefix + "/" + output.alias;
+            const QByteArray hash = contentHash(outDir.absoluteFilePath(output.path));
+            if (hash.isEmpty()) return 1;
+
+            auto existing = resourceByHash.constFind(hash);
+            if (existing != resourceByHash.constEnd()) {
+                aliases.insert(":" + resourcePath, ":" + existing.value());
+                continue;
+            }
+            resourceByHash.insert(hash, resourcePath);
+
+            if (!prefixOpen || output.prefix != currentPrefix) {
+                if (prefixOpen) xml.writeEndElement();
+                xml.writeStartElement("qresource");
+                xml.writeAttribute("prefix", output.prefix);
+                currentPrefix = output.prefix;
+                prefixOpen = true;
+            }
+            xml.writeStartElement("file");
+            xml.writeAttribute("alias", output.alias);
+            xml.writeCharacters(output.path);
+            xml.writeEndElement();
+        }
+        if (prefixOpen) xml.writeEndElement();
+
+        // Таблица псевдонимов лежит в корне ресурсов основного пакета
+        if (pack.key().isEmpty() || pack.key() == QLatin1String("core")) {
+            xml.writeStartElement("qresource");
+            xml.writeAttribute("prefix", "/");
+            xml.writeStartElement("file");
+            xml.writeCharacters("aliases.json");
+            xml.writeEndElement();
+            xml.writeEndElement();
+        }
+
+        xml.writeEndElement(); // RCC
+        xml.writeEndDocument();
+    }
+
+    // Пишем таблицу после всех пакетов: rcc прочитает ее уже при сборке
+    QFile aliasFile(outDir.filePath("aliases.json"));
+    if (!aliasFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err() << "assettool: не удалось записать " << aliasFile.fileName() << Qt::endl;
+        return 1;
+    }
+    aliasFile.write(QJsonDocument(aliases).toJson(QJsonDocument::Compact));
+
+    return 0;
+}
@@ -0,0 +1,240 @@
+// Замеры производительности окна игры и магазина (QtTest, QBENCHMARK).
+// Запускается без экрана: по умолчанию платформа Qt "offscreen".
+// Окна создаются настоящие, со всеми виджетами, звуками и кэшем картинок,
+// внутренние методы вызываются напрямую (MemoryBenchmark - friend окон).
+// Все сохранения (настройки, монеты, история, повторы партий) пишутся
+// во временную папку, которая удаляется после замеров.
+//
+// Замеры (строки _data - по сложностям и стилям карт):
+//   construction          - создание MemoryGameWindow (включая первую раздачу)
+//   startNewGame          - новая партия в открытом окне
+//   showAllImages         - сброс поля и показ всех карт с перерисовкой
+//   scriptedGame          - целая партия кликами без ошибок, с отрисовкой после каждого хода
+//   refreshGrid           - пересборка сетки магазина стилей
+//
+// Результаты в машиночитаемом виде для сравнения между сборками:
+//   Memory_bench -o bench.xml,xml       (или -csv, -o bench.txt,txt)
+//   Memory_bench scriptedGame:Hard/1    (одна строка)
+//   MEMORY_LATENCY_LOG=lat.csv Memory_bench scriptedGame   (и задержки кликов, см. latencyprobe.h)
+
+#include <QApplication>
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <memory>
+
+#include "assetpacks.h"
+#include "boardwidget.h"
+#include "difficulties.h"
+#include "imagecache.h"
+#include "latencyprobe.h"
+#include "memorygamewindow.h"
+#include "settingsstore.h"
+#include "stylecatalog.h"
+#include "styleswindow.h"
+
+class MemoryBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void construction_data();
+    void construction();
+    void startNewGame_data();
+    void startNewGame();
+    void showAllImages_data();
+    void showAllImages();
+    void scriptedGame_data();
+    void scriptedGame();
+    void refreshGrid();
+
+private:
+    static GameDifficulty* createDifficulty(int level);
+    static void addDifficultyRows();
+    static void addDifficultyStyleRows();
+    static bool waitForStyle(int styleId, qreal devicePixelRatio);
+
+    // Окно с выбранным стилем, картинки которого уже декодированы
+    static MemoryGameWindow* createWindow(int level, int styleId);
+
+    // Папка сохранений на время замеров
+    QTemporaryDir dataDir;
+};
+
+GameDifficulty* MemoryBenchmark::createDifficulty(int level)
+{
+    switch (level) {
+    case 0: return new EasyDifficulty();
+    case 1: return new MediumDifficulty();
+    default: return new HardDifficulty();
+    }
+}
+
+void MemoryBenchmark::addDifficultyRows()
+{
+    QTest::addColumn<int>("level");
+    for (int level = 0; level < 3; ++level) {
+        std::unique_ptr<GameDifficulty> difficulty(createDifficulty(level));
+        QTest::newRow(qPrintable(difficulty->getName())) << level;
+    }
+}
+
+void MemoryBenchmark::addDifficultyStyleRows()
+{
+    QTest::addColumn<int>("level");
+    QTest::addColumn<int>("styleId");
+    for (int level = 0; level < 3; ++level) {
+        std::unique_ptr<GameDifficulty> difficulty(createDifficulty(level));
+        for (const StyleInfo& style : StyleCatalog::instance().styles()) {
+            QTest::addRow("%s/%d", qPrintable(difficulty->getName()), style.id) << level << style.id;
+        }
+    }
+}
+
+bool MemoryBenchmark::waitForStyle(int styleId, qreal devicePixelRatio)
+{
+    ImageCache::instance().prefetch(styleId, devicePixelRatio);
+    return QTest::qWaitFor([&]() { return ImageCache::instance().isStyleReady(styleId, devicePixelRatio); }, 30000);
+}
+
+MemoryGameWindow* MemoryBenchmark::createWindow(int level, int styleId)
+{
+    MemoryGameWindow* window = new MemoryGameWindow(createDifficulty(level));
+    window->show();
+
+    // Стиль меняется напрямую, а не через настройки: замеры не трогают сохранения игрока
+    window->currentStyleId = styleId;
+    window->board->setCardStyle(StyleCatalog::instance().styleOrDefault(styleId));
+    waitForStyle(styleId, window->cardPixelRatio);
+    return window;
+}
+
+void MemoryBenchmark::initTestCase()
+{
+    // Каждая партия scriptedGame кончается победой и пишет историю и повтор.
+    // Сохранения игрока рядом с exe замеры не трогают: до первого обращения
+    // к хранилищам все они перенаправляются во временную папку
+    QVERIFY(dataDir.isValid());
+    SettingsStore::setDataDir(dataDir.path());
+
+    AssetPacks::registerCore();
+    StyleCatalog::instance().scan(QCoreApplication::applicationDirPath() + "/styles");
+    QVERIFY(!StyleCatalog::instance().styles().isEmpty());
+}
+
+void MemoryBenchmark::construction_data()
+{
+    addDifficultyRows();
+}
+
+void MemoryBenchmark::construction()
+{
+    QFETCH(int, level);
+
+    QBENCHMARK {
+        MemoryGameWindow window(createDifficulty(level));
+    }
+}
+
+void MemoryBenchmark::startNewGame_data()
+{
+    addDifficultyStyleRows();
+}
+
+void MemoryBenchmark::startNewGame()
+{
+    QFETCH(int, level);
+    QFETCH(int, styleId);
+    std::unique_ptr<MemoryGameWindow> window(createWindow(level, styleId));
+
+    QBENCHMARK {
+        window->startNewGame();
+    }
+}
+
+void MemoryBenchmark::showAllImages_data()
+{
+    addDifficultyStyleRows();
+}
+
+void MemoryBenchmark::showAllImages()
+{
+    QFETCH(int, level);
+    QFETCH(int, styleId);
+    std::unique_ptr<MemoryGameWindow> window(createWindow(level, styleId));
+
+    QBENCHMARK {
+        // Сброс входит в замер: без него показ открывал бы уже открытые карты
+        window->resetBoard(quint64(level) << 32 | quint32(styleId));
+        window->showAllImagesTemporarily();
+        window->board->repaint();
+    }
+    QVERIFY(window->previewShown);
+}
+
+void MemoryBenchmark::scriptedGame_data()
+{
+    addDifficultyStyleRows();
+}
+
+void MemoryBenchmark::scriptedGame()
+{
+    QFETCH(int, level);
+    QFETCH(int, styleId);
+    std::unique_ptr<MemoryGameWindow> window(createWindow(level, styleId));
+
+    QBENCHMARK {
+        // Победа закрывает окно - открываем снова, иначе скрытое поле не рисуется
+        window->show();
+        window->startNewGame();
+        window->hideAllCardsTimeout();
+
+        // Пары берутся из движка: партия всегда одинаковой длины и кончается победой
+        // Клик идет как от поля: с началом замера задержки (MEMORY_LATENCY_LOG)
+        auto click = [&](int index) {
+            LatencyProbe::instance().clickDelivered(index);
+            window->onCardClicked(index);
+        };
+        const GameEngine& engine = window->engine;
+        while (engine.phase() == GamePhase::Playing) {
+            int first = lowestCard(engine.flippableCards());
+            click(first);
+            click(engine.twinOf(first));
+            // Перерисовка после хода, как между кликами игрока
+            QCoreApplication::processEvents();
+        }
+    }
+    QCOMPARE(window->engine.phase(), GamePhase::Won);
+}
+
+void MemoryBenchmark::refreshGrid()
+{
+    StylesWindow shop;
+    shop.show();
+    for (const StyleInfo& style : StyleCatalog::instance().styles()) {
+        QVERIFY(waitForStyle(style.id, shop.devicePixelRatioF()));
+    }
+
+    QBENCHMARK {
+        shop.refreshGrid();
+        // Старые карточки удаляются через deleteLater - удаление тоже часть замера
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        QCoreApplication::processEvents();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Замеры не требуют экрана (CI, удаленные машины)
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    MemoryBenchmark benchmark;
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "benchmark.moc"
@@ -0,0 +1,226 @@
+// Симуляция партий без окна для подбора сложностей и наград.
+// Боты (случайный, с идеальной памятью, с забыванием) играют миллионы партий
+// на движке MemoryEngine по правилам каждой сложности, на всех ядрах сразу.
+// Время в партии моделируется (SimTiming): показ карт, время на открытие карты,
+// пауза на неверной паре, тик таймера раз в секунду - как в окне игры.
+//
+// Для каждой пары (сложность, бот) выводятся процент побед, распределение
+// ходов и ошибок, монеты за партию и за час игры (формулы из rewards.h).
+//
+// Пример:
+//   Memory_sim --games 2000000 --bots random,perfect,forgetful:0.1 --csv > sim.csv
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "difficulties.h"
+#include "gameengine.h"
+#include "rewards.h"
+#include "simulation.h"
+
+// Итоги серии партий. У каждого потока свои, в конце складываются
+struct SimStats {
+    std::uint64_t games = 0;
+    std::uint64_t wins = 0;
+    std::vector<std::uint64_t> attempts = std::vector<std::uint64_t>(256); // партий по числу ходов
+    std::vector<std::uint64_t> mistakes = std::vector<std::uint64_t>(256); // партий по числу ошибок
+    double coins = 0;
+    double seconds = 0;
+
+    void add(const SimResult& result, int reward) {
+        games++;
+        if (result.won) wins++;
+        attempts[std::min(result.attempts, 255)]++;
+        mistakes[std::min(result.mistakes, 255)]++;
+        coins += reward;
+        seconds += result.seconds;
+    }
+
+    void merge(const SimStats& other) {
+        games += other.games;
+        wins += other.wins;
+        for (std::size_t i = 0; i < attempts.size(); ++i) attempts[i] += other.attempts[i];
+        for (std::size_t i = 0; i < mistakes.size(); ++i) mistakes[i] += other.mistakes[i];
+        coins += other.coins;
+        seconds += other.seconds;
+    }
+};
+
+static double mean(const std::vector<std::uint64_t>& histogram, std::uint64_t total)
+{
+    double sum = 0;
+    for (std::size_t i = 0; i < histogram.size(); ++i) sum += double(i) * histogram[i];
+    return total ? sum / total : 0;
+}
+
+static int percentile(const std::vector<std::uint64_t>& histogram, std::uint64_t total, double p)
+{
+    std::uint64_t need = static_cast<std::uint64_t>(p * total);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < histogram.size(); ++i) {
+        seen += histogram[i];
+        if (seen > need) return static_cast<int>(i);
+    }
+    return static_cast<int>(histogram.size()) - 1;
+}
+
+static QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Симуляция партий ботами для настройки сложностей и наград");
+    parser.addHelpOption();
+
+    QCommandLineOption gamesOption("games", "Партий на каждую пару сложность/бот", "count", "1000000");
+    QCommandLineOption botsOption("bots", "Боты через запятую: random, perfect, forgetful[:rate]",
+                                  "list", "random,perfect,forgetful:0.05,forgetful:0.2");
+    QCommandLineOption threadsOption("threads", "Число потоков (по умолчанию - все ядра)", "count");
+    QCommandLineOption seedOption("seed", "Начальное зерно (одинаковое зерно и --games - одинаковые результаты при любом --threads)", "seed", "1");
+    QCommandLineOption flipOption("flip-seconds", "Время бота на открытие карты (сек)", "seconds", "1.0");
+    QCommandLineOption previewOption("preview-rate", "Сколько карт бот запоминает за секунду показа", "cards", "1.0");
+    QCommandLineOption csvOption("csv", "Вывод в CSV вместо таблицы");
+    parser.addOptions({ gamesOption, botsOption, threadsOption, seedOption, flipOption, previewOption, csvOption });
+    parser.process(app);
+
+    const std::uint64_t gamesPerRun = parser.value(gamesOption).toULongLong();
+    const std::uint64_t seed = parser.value(seedOption).toULongLong();
+    const bool csv = parser.isSet(csvOption);
+
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    if (parser.isSet(threadsOption)) threadCount = std::max(1u, parser.value(threadsOption).toUInt());
+
+    const QStringList botNames = parser.value(botsOption).split(',', Qt::SkipEmptyParts);
+    for (const QString& name : botNames) {
+        if (!createBot(name.trimmed().toStdString())) {
+            err() << "Неизвестный бот: " << name << Qt::endl;
+            return 1;
+        }
+    }
+    if (gamesPerRun == 0 || botNames.isEmpty()) {
+        err() << "Нечего симулировать" << Qt::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<GameDifficulty>> difficulties;
+    difficulties.emplace_back(new EasyDifficulty());
+    difficulties.emplace_back(new MediumDifficulty());
+    difficulties.emplace_back(new HardDifficulty());
+
+    if (csv) {
+        out() << "difficulty,bot,games,win_rate,attempts_mean,attempts_p50,attempts_p90,attempts_p99,"
+                 "mistakes_mean,mistakes_p90,coins_per_game,coins_per_hour,games_per_second" << Qt::endl;
+    } else {
+        out() << "Потоков: " << threadCount << ", партий на строку: " << gamesPerRun << Qt::endl;
+        out() << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+                     .arg("Сложность", -10).arg("Бот", -16).arg("Победы", 8).arg("Ходы ср", 8)
+                     .arg("p50/p90/p99", 12).arg("Ошибки", 7).arg("Монет/игра", 11)
+                     .arg("Монет/час", 10).arg("Партий/с", 11) << Qt::endl;
+    }
+
+    for (const auto& difficulty : difficulties) {
+        GameRules rules;
+        rules.rows = difficulty->getRows();
+        rules.cols = difficulty->getCols();
+        rules.gameTime = difficulty->getGameTime();
+        rules.maxMistakes = difficulty->getMaxMistakes();
+
+        SimTiming timing;
+        timing.memoryTime = difficulty->getMemoryTime();
+        timing.flipSeconds = parser.value(flipOption).toDouble();
+        timing.previewCardsPerSecond = parser.value(previewOption).toDouble();
+
+        const double multiplier = difficulty->getCoinMultiplier();
+
+        for (const QString& botName : botNames) {
+            const std::string botSpec = botName.trimmed().toStdString();
+
+            // Каждый поток играет свои куски партий (t, t + threadCount, ...)
+            // на своем движке и боте. Итоги копятся в локальной SimStats и отдаются
+            // в threadStats один раз в конце: счетчики соседних потоков в одном
+            // массиве делили бы строки кэша
+            std::vector<SimStats> threadStats(threadCount);
+            std::vector<std::thread> threads;
+            const std::uint64_t chunks = (gamesPerRun + SIM_CHUNK_GAMES - 1) / SIM_CHUNK_GAMES;
+            auto started = std::chrono::steady_clock::now();
+
+            for (unsigned t = 0; t < threadCount; ++t) {
+                threads.emplace_back([&, t]() {
+                    GameEngine engine(rules);
+                    std::unique_ptr<Bot> bot = createBot(botSpec);
+                    SimStats stats;
+                    for (std::uint64_t chunk = t; chunk < chunks; chunk += threadCount) {
+                        SplitMix64 rng(chunkSeed(seed, chunk));
+                        const std::uint64_t games = std::min(SIM_CHUNK_GAMES, gamesPerRun - chunk * SIM_CHUNK_GAMES);
+                        for (std::uint64_t i = 0; i < games; ++i) {
+                            SimResult result = simulateGame(engine, *bot, rng, timing);
+                            int reward = result.won ? winReward(result.attempts, multiplier)
+                                                    : lossReward(result.matchedPairs, multiplier);
+                            stats.add(result, reward);
+                        }
+                    }
+                    threadStats[t] = std::move(stats);
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+            SimStats total;
+            for (const SimStats& stats : threadStats) total.merge(stats);
+
+            const QString botLabel = QString::fromStdString(createBot(botSpec)->name());
+            const double winRate = double(total.wins) / total.games;
+            const double coinsPerGame = total.coins / total.games;
+            const double coinsPerHour = total.seconds > 0 ? total.coins * 3600.0 / total.seconds : 0;
+            const double gamesPerSecond = elapsed > 0 ? total.games / elapsed : 0;
+
+            if (csv) {
+                out() << difficulty->getName() << ',' << botLabel << ',' << total.games << ','
+                      << winRate << ',' << mean(total.attempts, total.games) << ','
+                      << percentile(total.attempts, total.games, 0.5) << ','
+                      << percentile(total.attempts, total.games, 0.9) << ','
+                      << percentile(total.attempts, total.games, 0.99) << ','
+                      << mean(total.mistakes, total.games) << ','
+                      << percentile(total.mistakes, total.games, 0.9) << ','
+                      << coinsPerGame << ',' << coinsPerHour << ',' << gamesPerSecond << Qt::endl;
+            } else {
+                QString spread = QString("%1/%2/%3")
+                                     .arg(percentile(total.attempts, total.games, 0.5))
+                                     .arg(percentile(total.attempts, total.games, 0.9))
+                                     .arg(percentile(total.attempts, total.games, 0.99));
+                out() << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9")
+                             .arg(difficulty->getName(), -10).arg(botLabel, -16)
+                             .arg(QString::number(winRate * 100, 'f', 1) + "%", 8)
+                             .arg(mean(total.attempts, total.games), 8, 'f', 1)
+                             .arg(spread, 12)
+                             .arg(mean(total.mistakes, total.games), 7, 'f', 2)
+                             .arg(coinsPerGame, 11, 'f', 1)
+                             .arg(coinsPerHour, 10, 'f', 0)
+                             .arg(gamesPerSecond, 11, 'f', 0) << Qt::endl;
+            }
+        }
+    }
+
+    return 0;
+}
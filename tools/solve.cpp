@@ -0,0 +1,155 @@
+// Решатель: сколько ходов и ошибок нужно, чтобы открыть поле.
+// Для игрока с идеальной памятью считает точно (ExactSolver, динамическое
+// программирование), для ботов с забыванием - методом Монте-Карло на всех ядрах.
+// По распределению ошибок видно, сколько партий выигрывается при пределе
+// ошибок (GameDifficulty::getMaxMistakes), а по среднему числу ходов - сколько монет дает кривая наград
+// (winReward из rewards.h).
+//
+// Пример:
+//   Memory_solve --bots forgetful:0.05,forgetful:0.2 --caps 6,8,10,12,15
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "difficulties.h"
+#include "solver.h"
+
+static QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+// Одна строка отчета: ходы, ошибки и для каждого предела ошибок - доля побед и монеты
+// (в среднем за партию, где проигрыш дает 0, и за одну победу)
+static void printResult(const QString& difficulty, const QString& model, const SolverResult& result,
+                        int pairCount, double multiplier, const QList<int>& caps, double milliseconds, bool csv)
+{
+    if (csv) {
+        out() << difficulty << ',' << model << ',' << result.expectedAttempts << ','
+              << result.expectedMistakes() << ',' << result.mistakePercentile(0.5) << ','
+              << result.mistakePercentile(0.9) << ',' << result.mistakePercentile(0.99);
+        for (int cap : caps) {
+            out() << ',' << result.winProbability(cap) << ',' << result.expectedWinReward(pairCount, cap, multiplier)
+                  << ',' << result.expectedRewardPerWin(pairCount, cap, multiplier);
+        }
+        out() << ',' << milliseconds << Qt::endl;
+        return;
+    }
+
+    out() << QString("%1 %2 ходов %3, ошибок %4 (p50 %5, p90 %6, p99 %7), %8 мс")
+                 .arg(difficulty, -8).arg(model, -16)
+                 .arg(result.expectedAttempts, 0, 'f', 2)
+                 .arg(result.expectedMistakes(), 0, 'f', 2)
+                 .arg(result.mistakePercentile(0.5))
+                 .arg(result.mistakePercentile(0.9))
+                 .arg(result.mistakePercentile(0.99))
+                 .arg(milliseconds, 0, 'f', 1) << Qt::endl;
+    for (int cap : caps) {
+        out() << QString("    предел %1: побед %2%, монет за партию %3, за победу %4")
+                     .arg(cap, 3)
+                     .arg(result.winProbability(cap) * 100, 6, 'f', 2)
+                     .arg(result.expectedWinReward(pairCount, cap, multiplier), 0, 'f', 1)
+                     .arg(result.expectedRewardPerWin(pairCount, cap, multiplier), 0, 'f', 1) << Qt::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Ожидаемое число ходов и ошибок для полей игры");
+    parser.addHelpOption();
+
+    QCommandLineOption botsOption("bots", "Боты для Монте-Карло через запятую (пусто - только точное решение)",
+                                  "list", "forgetful:0.05,forgetful:0.2");
+    QCommandLineOption capsOption("caps", "Пределы ошибок для сравнения", "list", "6,8,10,12,15");
+    QCommandLineOption gamesOption("games", "Партий Монте-Карло на каждого бота", "count", "1000000");
+    QCommandLineOption threadsOption("threads", "Число потоков (по умолчанию - все ядра)", "count");
+    QCommandLineOption seedOption("seed", "Зерно Монте-Карло (результат не зависит от --threads)", "seed", "1");
+    QCommandLineOption previewOption("preview-rate", "Сколько карт игрок запоминает за секунду показа", "cards", "1.0");
+    QCommandLineOption csvOption("csv", "Вывод в CSV");
+    parser.addOptions({ botsOption, capsOption, gamesOption, threadsOption, seedOption, previewOption, csvOption });
+    parser.process(app);
+
+    QList<int> caps;
+    for (const QString& cap : parser.value(capsOption).split(',', Qt::SkipEmptyParts)) {
+        caps.append(cap.trimmed().toInt());
+    }
+
+    const QStringList botNames = parser.value(botsOption).split(',', Qt::SkipEmptyParts);
+    for (const QString& name : botNames) {
+        if (!createBot(name.trimmed().toStdString())) {
+            err() << "Неизвестный бот: " << name << Qt::endl;
+            return 1;
+        }
+    }
+
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    if (parser.isSet(threadsOption)) threadCount = std::max(1u, parser.value(threadsOption).toUInt());
+    const std::uint64_t games = parser.value(gamesOption).toULongLong();
+    const std::uint64_t seed = parser.value(seedOption).toULongLong();
+    const double previewRate = parser.value(previewOption).toDouble();
+    const bool csv = parser.isSet(csvOption);
+
+    if (csv) {
+        out() << "difficulty,model,attempts_mean,mistakes_mean,mistakes_p50,mistakes_p90,mistakes_p99";
+        for (int cap : caps) {
+            out() << ",win_rate_cap" << cap << ",coins_per_game_cap" << cap << ",coins_per_win_cap" << cap;
+        }
+        out() << ",milliseconds" << Qt::endl;
+    }
+
+    std::vector<std::unique_ptr<GameDifficulty>> difficulties;
+    difficulties.emplace_back(new EasyDifficulty());
+    difficulties.emplace_back(new MediumDifficulty());
+    difficulties.emplace_back(new HardDifficulty());
+
+    for (const auto& difficulty : difficulties) {
+        GameRules rules;
+        rules.rows = difficulty->getRows();
+        rules.cols = difficulty->getCols();
+        rules.gameTime = difficulty->getGameTime();
+        rules.maxMistakes = difficulty->getMaxMistakes();
+
+        SimTiming timing;
+        timing.memoryTime = difficulty->getMemoryTime();
+        timing.previewCardsPerSecond = previewRate;
+
+        const int cardCount = rules.rows * rules.cols;
+        const int previewCards = std::min(cardCount, static_cast<int>(timing.memoryTime * previewRate));
+        const double multiplier = difficulty->getCoinMultiplier();
+
+        auto started = std::chrono::steady_clock::now();
+        ExactSolver exact(cardCount);
+        SolverResult result = exact.solve(previewCards);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        printResult(difficulty->getName(), "perfect (exact)", result, cardCount / 2, multiplier, caps, elapsed, csv);
+
+        for (const QString& botName : botNames) {
+            const std::string botSpec = botName.trimmed().toStdString();
+            started = std::chrono::steady_clock::now();
+            result = monteCarloSolve(rules, botSpec, timing, games, threadCount, seed);
+            elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+            printResult(difficulty->getName(), QString::fromStdString(createBot(botSpec)->name()),
+                        result, cardCount / 2, multiplier, caps, elapsed, csv);
+        }
+    }
+
+    return 0;
+}